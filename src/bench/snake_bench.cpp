@@ -0,0 +1,268 @@
+// Snake engine footprint and throughput report.
+//
+// Counts every heap allocation made by the engine through a replaced global
+// operator new, so the numbers below cover a SnakeEngine's inline size plus
+// everything it owns on the heap, next to the same figures for the Game
+// singleton it replaced, whose body deque allocated as it slid and grew
+// through the same games. Every engine here keeps its high score in memory,
+// so file streams do not show up in the numbers and no file is written.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../brick_game/GameRunner.h"
+#include "../brick_game/snake/snake.h"
+
+namespace {
+std::size_t g_allocations = 0;
+std::size_t g_allocated_bytes = 0;
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++g_allocations;
+  g_allocated_bytes += size;
+  if (void* ptr = std::malloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace s21;
+
+namespace {
+// Members of the Game singleton as the baseline commit declared them, with
+// the allocations its initializeGame() and moveSnake() made
+struct BaselineGame {
+  GameState current_state_ = START_SCREEN;
+  int** game_field_ = nullptr;
+  int** next_field_ = nullptr;
+  std::deque<Point> snake_;
+  Point food_position_{0, 0};
+  int score_ = 0;
+  int high_score_ = 0;
+  int level_ = 1;
+  int speed_ = 500;
+  Point snake_direction_{1, 0};
+  const std::string kHighScoreFilePath = "high_score.txt";
+
+  BaselineGame() { initializeGame(); }
+  ~BaselineGame() { freeFields(); }
+
+  void freeFields() {
+    if (game_field_ != nullptr) {
+      for (int i = 0; i < FIELD_HEIGHT; ++i) delete[] game_field_[i];
+      delete[] game_field_;
+    }
+    if (next_field_ != nullptr) {
+      for (int i = 0; i < 4; ++i) delete[] next_field_[i];
+      delete[] next_field_;
+    }
+  }
+
+  // Reallocates both fields and rebuilds the body, as every reset did
+  void initializeGame() {
+    freeFields();
+    game_field_ = new int*[FIELD_HEIGHT];
+    for (int i = 0; i < FIELD_HEIGHT; ++i) {
+      game_field_[i] = new int[FIELD_WIDTH]();
+    }
+    next_field_ = new int*[4];
+    for (int i = 0; i < 4; ++i) next_field_[i] = new int[4]();
+    snake_.clear();
+    for (int i = 0; i < 4; ++i) {
+      snake_.push_back({FIELD_WIDTH / 2 - i, FIELD_HEIGHT / 2});
+    }
+  }
+
+  // The body half of moveSnake(): the tail stays when food was eaten
+  void moveSnake(Point head, bool food_eaten) {
+    if (!food_eaten) snake_.pop_back();
+    snake_.push_front(head);
+  }
+};
+
+// Next cell on a Hamiltonian cycle of the board: serpentine over columns
+// 1..FIELD_WIDTH-1, then back up column 0. Following it never collides, so
+// every game runs all the way to the win condition.
+Point nextOnCycle(Point p) {
+  if (p.x == 0) return p.y == 0 ? Point{1, 0} : Point{0, p.y - 1};
+  bool rightward = p.y % 2 == 0;
+  if (rightward) return p.x < FIELD_WIDTH - 1 ? Point{p.x + 1, p.y}
+                                              : Point{p.x, p.y + 1};
+  if (p.x > 1 || p.y == FIELD_HEIGHT - 1) return Point{p.x - 1, p.y};
+  return Point{p.x, p.y + 1};
+}
+
+// Plays `games` games along the cycle. on_tick(head, food_eaten) runs after
+// every move and on_game() before every game.
+template <typename OnGame, typename OnTick>
+long long playOnCycle(SnakeEngine& game, int games, int* wins, OnGame on_game,
+                      OnTick on_tick) {
+  long long ticks = 0;
+  for (int g = 0; g < games; ++g) {
+    game.resetGame();
+    game.handleUserInput(Start, false);
+    on_game();
+    Point head{FIELD_WIDTH / 2, FIELD_HEIGHT / 2};
+    Point dir{1, 0};
+    int score = 0;
+    for (bool running = true; running; ++ticks) {
+      Point next = nextOnCycle(head);
+      Point want{next.x - head.x, next.y - head.y};
+      if (want.x == dir.y && want.y == -dir.x) {
+        game.handleUserInput(Left, false);
+      }
+      if (want.x == -dir.y && want.y == dir.x) {
+        game.handleUserInput(Right, false);
+      }
+      dir = want;
+      head = next;
+      const GameFrame_t* frame = game.borrowState();
+      running = frame->info.current_game_state == GAME_RUNNING;
+      *wins += frame->info.current_game_state == GAME_OVER_WIN;
+      on_tick(head, frame->info.score > score);
+      score = frame->info.score;
+      game.releaseState(frame);
+    }
+  }
+  return ticks;
+}
+
+// Frontend model for the jitter report: 10 ms ticks, and every fourth frame
+// takes 25 ms to paint
+constexpr auto kTickPeriod = std::chrono::milliseconds(10);
+constexpr auto kPaintStall = std::chrono::milliseconds(25);
+constexpr int kJitterFrames = 60;
+
+void paint(int frame) {
+  if (frame % 4 == 3) std::this_thread::sleep_for(kPaintStall);
+}
+
+void printJitter(const char* label, const s21_controller::JitterReport& r) {
+  std::printf("%-28s: p50 %.0f us, p99 %.0f us, max %.0f us\n", label,
+              r.p50_us, r.p99_us, r.max_us);
+}
+
+// Ticks and paints on one thread, the way the frontends' timers do
+s21_controller::JitterReport inlineJitter(SnakeEngine& game) {
+  using Clock = std::chrono::steady_clock;
+  s21_controller::JitterStats stats;
+  Clock::time_point scheduled = Clock::now();
+  for (int frame = 0; frame < kJitterFrames; ++frame) {
+    scheduled += kTickPeriod;
+    std::this_thread::sleep_until(scheduled);
+    const Clock::time_point now = Clock::now();
+    stats.record(now - scheduled);
+    game.step(std::chrono::duration<double>(kTickPeriod).count());
+    game.releaseState(game.snapshot());
+    paint(frame);
+    if (now - scheduled > kTickPeriod) scheduled = now;
+  }
+  return stats.report();
+}
+
+// Ticks on a GameRunner while this thread paints its frames and sends one
+// input (ignored by Snake) per frame
+void runnerJitter() {
+  s21_controller::GameRunner runner(kTickPeriod);
+  runner.start();
+  for (int frame = 0; frame < kJitterFrames; ++frame) {
+    if (runner.latest() == nullptr) break;
+    runner.userInput(AltAction, false);
+    std::this_thread::sleep_for(kTickPeriod);
+    paint(frame);
+  }
+  runner.stop();
+  printJitter("tick lateness, runner", runner.jitterReport());
+  printJitter("input to tick, runner", runner.inputLatencyReport());
+}
+}  // namespace
+
+int main() {
+  std::printf("sizeof, baseline Game       : %zu bytes\n",
+              sizeof(BaselineGame));
+  std::printf("sizeof(SnakeEngine)         : %zu bytes\n",
+              sizeof(SnakeEngine));
+
+  // Record which moves of the seeded games eat food, so the baseline body
+  // replays exactly the moves the engine under test makes below
+  const int kGames = 20;
+  const std::uint64_t kSeed = 1;
+  constexpr char kNewGame = 2;
+  std::vector<char> moves;
+  {
+    SnakeEngine recorder(std::make_unique<MemoryHighScoreSink>(), kSeed);
+    int wins = 0;
+    playOnCycle(
+        recorder, kGames, &wins, [&] { moves.push_back(kNewGame); },
+        [&](Point, bool food_eaten) { moves.push_back(food_eaten); });
+  }
+
+  std::size_t before = g_allocated_bytes;
+  std::size_t before_count = g_allocations;
+  {
+    BaselineGame baseline;
+    std::printf("heap at construction, before: %zu bytes in %zu allocations\n",
+                g_allocated_bytes - before, g_allocations - before_count);
+    before = g_allocated_bytes;
+    before_count = g_allocations;
+    Point head{0, 0};
+    for (char move : moves) {
+      if (move == kNewGame) {
+        baseline.initializeGame();
+        head = {FIELD_WIDTH / 2, FIELD_HEIGHT / 2};
+        continue;
+      }
+      head = nextOnCycle(head);
+      baseline.moveSnake(head, move != 0);
+    }
+    std::printf("heap while playing, before  : %zu bytes in %zu allocations\n",
+                g_allocated_bytes - before, g_allocations - before_count);
+  }
+
+  // The sink is allocated before counting starts; the engine owns it after
+  auto sink = std::make_unique<MemoryHighScoreSink>();
+  before = g_allocated_bytes;
+  before_count = g_allocations;
+  SnakeEngine game(std::move(sink), kSeed);
+  std::printf("heap at construction, engine: %zu bytes in %zu allocations\n",
+              g_allocated_bytes - before, g_allocations - before_count);
+
+  int wins = 0;
+  before = g_allocated_bytes;
+  before_count = g_allocations;
+  auto start = std::chrono::steady_clock::now();
+  long long ticks = playOnCycle(game, kGames, &wins, [] {}, [](Point, bool) {});
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  std::printf("heap while playing, engine  : %zu bytes in %zu allocations\n",
+              g_allocated_bytes - before, g_allocations - before_count);
+  std::printf("games won                   : %d of %d\n", wins, kGames);
+  std::printf("ticks                       : %lld (%.1f ns/tick)\n", ticks,
+              seconds * 1e9 / static_cast<double>(ticks));
+
+  // The jitter runs keep their high scores in memory as well. A GameRunner
+  // drives the default engine, so that one gets its sink swapped.
+  SnakeEngine paced(std::make_unique<MemoryHighScoreSink>());
+  paced.handleUserInput(Start, false);
+  printJitter("tick lateness, inline", inlineJitter(paced));
+  SnakeEngine& shared = SnakeEngine::getInstance();
+  shared.setHighScoreSink(std::make_unique<MemoryHighScoreSink>());
+  shared.resetGame();
+  userInput(Start, false);
+  runnerJitter();
+  return 0;
+}
@@ -0,0 +1,253 @@
+// Tetris collision-test and snapshot throughput report.
+//
+// Fills boards with random locked blocks, then asks every piece placement
+// whether it fits, once through the engine's row-mask bitboard and once
+// through the 4x4 cell scan over an int grid the engine used before, and
+// every fitting piece is rotated both ways through the wall-kick tables. The
+// same boards are then rendered with a falling piece, through
+// tetris_snapshot() and through the per-cell piece overlay it replaced.
+// Both pairs of answers are compared so the report doubles as a
+// consistency check. Finally a game is played by the placement-search bot,
+// timing every search on one thread and on a pool with one thread per CPU;
+// both must choose the same move. The bot then plays in real time at 60 Hz
+// to measure how many frames pass between locking a piece and the next one.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "../brick_game/tetris/tetris.h"
+#include "../brick_game/tetris/tetris_bot.h"
+
+using namespace s21;
+
+namespace {
+using Grid = int[TETRIS_BOARD_HEIGHT][TETRIS_BOARD_WIDTH];
+
+// The per-cell collision test the bitboard replaced
+bool cellScanFits(const Grid& grid, int piece_x, int piece_y, int type,
+                  int rotation) {
+  const TetrominoShape& s = tetrominoes[type][rotation];
+  for (int r = 0; r < TETROMINO_GRID_SIZE; ++r) {
+    for (int c = 0; c < TETROMINO_GRID_SIZE; ++c) {
+      if (s.shape[r][c] != 1) continue;
+      int board_r = piece_y + r;
+      int board_c = piece_x + c;
+      if (board_c < 0 || board_c >= TETRIS_BOARD_WIDTH || board_r < 0 ||
+          board_r >= TETRIS_BOARD_HEIGHT) {
+        return false;
+      }
+      if (grid[board_r][board_c] != EMPTY) return false;
+    }
+  }
+  return true;
+}
+
+// Fills the lower part of the board with random blocks, mirrored in the grid
+void fillBoard(TetrisContext* ctx, Grid& grid, GameRandom_t* rng) {
+  for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
+    ctx->board.rows[r] = TETRIS_ROW_EMPTY;
+    for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
+      bool filled = r >= TETRIS_BOARD_HEIGHT / 2 && boundedGameRandom(rng, 2);
+      grid[r][c] = filled ? BODY : EMPTY;
+      if (filled) ctx->board.rows[r] |= 1u << (c + TETRIS_WALL_BITS);
+    }
+  }
+}
+
+// The snapshot overlay the compositor replaced: every board cell rescans
+// the whole 4x4 piece shape
+void legacyComposite(const TetrisContext* ctx, int* const* field) {
+  const CurrentPieceState& p = ctx->current_piece;
+  const TetrominoShape& s = tetrominoes[p.type][p.rotation];
+  for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
+    for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
+      field[r][c] = (ctx->board.rows[r] >> (c + TETRIS_WALL_BITS)) & 1u ? BODY : EMPTY;
+      for (int pr = 0; pr < TETROMINO_GRID_SIZE; ++pr)
+        for (int pc = 0; pc < TETROMINO_GRID_SIZE; ++pc)
+          if (s.shape[pr][pc] == 1 && p.y + pr == r && p.x + pc == c)
+            field[r][c] = BODY;
+    }
+  }
+}
+
+// Places the falling piece above the random stack
+void placePiece(TetrisContext* ctx, GameRandom_t* rng) {
+  ctx->current_piece.type = (int)boundedGameRandom(rng, NUM_TETROMINO_TYPES);
+  ctx->current_piece.rotation = (int)boundedGameRandom(rng, NUM_TETROMINO_ROTATIONS);
+  ctx->current_piece.x = (int)boundedGameRandom(rng, TETRIS_BOARD_WIDTH - 3);
+  ctx->current_piece.y = 0;
+  ctx->current_piece.active = true;
+}
+
+bool sameField(const GameFrame_t& a, const GameFrame_t& b) {
+  for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r)
+    for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c)
+      if (a.info.field[r][c] != b.info.field[r][c]) return false;
+  return true;
+}
+}  // namespace
+
+int main() {
+  const int kBoards = 2000;
+  TetrisContext* ctx = tetris_create(nullptr);
+  GameRandom_t rng;
+  seedGameRandom(&rng, 2024);
+  static Grid grid;
+
+  long long queries = 0, fits = 0, mismatches = 0, rotations = 0, kicked = 0;
+  double bitboard_seconds = 0.0, scan_seconds = 0.0, rotate_seconds = 0.0;
+  for (int b = 0; b < kBoards; ++b) {
+    fillBoard(ctx, grid, &rng);
+    long long bitboard_fits = 0, scan_fits = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < NUM_TETROMINO_TYPES; ++t)
+      for (int rot = 0; rot < NUM_TETROMINO_ROTATIONS; ++rot)
+        for (int y = -2; y < TETRIS_BOARD_HEIGHT; ++y)
+          for (int x = -3; x < TETRIS_BOARD_WIDTH; ++x)
+            bitboard_fits += tetris_piece_fits(ctx, x, y, t, rot);
+    auto middle = std::chrono::steady_clock::now();
+    for (int t = 0; t < NUM_TETROMINO_TYPES; ++t)
+      for (int rot = 0; rot < NUM_TETROMINO_ROTATIONS; ++rot)
+        for (int y = -2; y < TETRIS_BOARD_HEIGHT; ++y)
+          for (int x = -3; x < TETRIS_BOARD_WIDTH; ++x)
+            scan_fits += cellScanFits(grid, x, y, t, rot);
+    auto end = std::chrono::steady_clock::now();
+    for (int t = 0; t < NUM_TETROMINO_TYPES; ++t)
+      for (int rot = 0; rot < NUM_TETROMINO_ROTATIONS; ++rot)
+        for (int y = -2; y < TETRIS_BOARD_HEIGHT; ++y)
+          for (int x = -3; x < TETRIS_BOARD_WIDTH; ++x)
+            mismatches += cellScanFits(grid, x, y, t, rot) !=
+                          tetris_piece_fits(ctx, x, y, t, rot);
+
+    // Every fitting position rotated both ways through the SRS kick tables
+    auto rotate_start = std::chrono::steady_clock::now();
+    for (int t = 0; t < NUM_TETROMINO_TYPES; ++t)
+      for (int rot = 0; rot < NUM_TETROMINO_ROTATIONS; ++rot)
+        for (int y = 0; y < TETRIS_BOARD_HEIGHT; ++y)
+          for (int x = -3; x < TETRIS_BOARD_WIDTH; ++x) {
+            if (!tetris_board_fits(&ctx->board, x, y, t, rot)) continue;
+            for (int direction = -1; direction <= 1; direction += 2) {
+              int kx = x, ky = y, krot = rot;
+              tetris_board_rotate(&ctx->board, t, &kx, &ky, &krot, direction);
+              kicked += kx != x || ky != y;
+              ++rotations;
+            }
+          }
+    auto rotate_end = std::chrono::steady_clock::now();
+
+    bitboard_seconds += std::chrono::duration<double>(middle - start).count();
+    scan_seconds += std::chrono::duration<double>(end - middle).count();
+    rotate_seconds += std::chrono::duration<double>(rotate_end - rotate_start).count();
+    queries += NUM_TETROMINO_TYPES * NUM_TETROMINO_ROTATIONS *
+               (TETRIS_BOARD_HEIGHT + 2) * (TETRIS_BOARD_WIDTH + 3);
+    fits += bitboard_fits;
+    mismatches += bitboard_fits != scan_fits;
+  }
+
+  const int kFrames = 200;
+  static GameFrame_t snapshot, legacy;
+  bindGameFrame(&legacy);
+  double snapshot_seconds = 0.0, legacy_seconds = 0.0, ghost_seconds = 0.0;
+  long long frames = 0;
+  for (int b = 0; b < kBoards; ++b) {
+    fillBoard(ctx, grid, &rng);
+    placePiece(ctx, &rng);
+
+    tetris_set_ghost(ctx, false);
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) tetris_snapshot(ctx, &snapshot);
+    auto middle = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) legacyComposite(ctx, legacy.info.field);
+    auto end = std::chrono::steady_clock::now();
+    mismatches += !sameField(snapshot, legacy);
+
+    tetris_set_ghost(ctx, true);
+    auto ghost_start = std::chrono::steady_clock::now();
+    for (int f = 0; f < kFrames; ++f) tetris_snapshot(ctx, &snapshot);
+    auto ghost_end = std::chrono::steady_clock::now();
+
+    snapshot_seconds += std::chrono::duration<double>(middle - start).count();
+    legacy_seconds += std::chrono::duration<double>(end - middle).count();
+    ghost_seconds += std::chrono::duration<double>(ghost_end - ghost_start).count();
+    frames += kFrames;
+  }
+  tetris_destroy(ctx);
+
+  const int kMoves = 300;
+  TetrisContext* game = tetris_create(nullptr);
+  tetris_seed(game, 7);
+  tetris_input(game, Start, false);
+  tetris_step(game);
+  TetrisBot* single = tetris_bot_create(1);
+  TetrisBot* pool = tetris_bot_create(0);
+  double single_seconds = 0.0, pool_seconds = 0.0;
+  for (int m = 0; m < kMoves; ++m) {
+    if (game->overall_game_state != GAME_RUNNING) {
+      tetris_input(game, Start, false);
+      tetris_step(game);
+    }
+    auto start = std::chrono::steady_clock::now();
+    TetrisBotMove a = tetris_bot_search(single, game, true);
+    auto middle = std::chrono::steady_clock::now();
+    TetrisBotMove b = tetris_bot_search(pool, game, true);
+    auto end = std::chrono::steady_clock::now();
+    single_seconds += std::chrono::duration<double>(middle - start).count();
+    pool_seconds += std::chrono::duration<double>(end - middle).count();
+    mismatches += a.x != b.x || a.y != b.y || a.rotation != b.rotation;
+    for (int i = 0; i < a.action_count; ++i) tetris_input(game, a.actions[i], false);
+  }
+  double evaluations = static_cast<double>(tetris_bot_evaluations(single));
+
+  // Real-time play at 60 Hz: count the frames in which no piece falls,
+  // i.e. the latency between locking one piece and controlling the next
+  const int kEntryDelays[] = {0, 100};
+  double idle_frames_per_piece[2] = {0.0, 0.0};
+  for (int d = 0; d < 2; ++d) {
+    tetris_seed(game, 7);
+    tetris_set_entry_delay(game, kEntryDelays[d]);
+    tetris_set_autopilot(game, true);
+    tetris_input(game, Start, false);
+    long long idle = 0, pieces = 0;
+    bool was_active = false;
+    for (int f = 0; f < 60 * 600 && game->overall_game_state == GAME_RUNNING; ++f) {
+      tetris_advance(game, 1.0 / 60.0);
+      bool active = game->current_piece.active;
+      idle += !active;
+      pieces += active && !was_active;
+      was_active = active;
+    }
+    tetris_set_autopilot(game, false);
+    idle_frames_per_piece[d] = static_cast<double>(idle) / static_cast<double>(pieces);
+  }
+  int threads = tetris_bot_threads(pool);
+  tetris_bot_destroy(pool);
+  tetris_bot_destroy(single);
+  tetris_destroy(game);
+
+  std::printf("sizeof(TetrisContext)       : %zu bytes\n", sizeof(TetrisContext));
+  std::printf("placements tested           : %lld (%lld fit)\n", queries, fits);
+  std::printf("bitboard                    : %.2f ns/test\n",
+              bitboard_seconds * 1e9 / static_cast<double>(queries));
+  std::printf("4x4 cell scan               : %.2f ns/test\n",
+              scan_seconds * 1e9 / static_cast<double>(queries));
+  std::printf("rotation with wall kicks    : %.2f ns/rotation (%.1f%% kicked)\n",
+              rotate_seconds * 1e9 / static_cast<double>(rotations),
+              100.0 * static_cast<double>(kicked) / static_cast<double>(rotations));
+  std::printf("snapshot                    : %.1f ns/frame\n",
+              snapshot_seconds * 1e9 / static_cast<double>(frames));
+  std::printf("snapshot with ghost         : %.1f ns/frame\n",
+              ghost_seconds * 1e9 / static_cast<double>(frames));
+  std::printf("per-cell overlay (field)    : %.1f ns/frame\n",
+              legacy_seconds * 1e9 / static_cast<double>(frames));
+  std::printf("bot search, 1 thread        : %.1f us/move, %.2f M boards/s\n",
+              single_seconds * 1e6 / kMoves, evaluations / single_seconds / 1e6);
+  std::printf("bot search, %2d threads     : %.1f us/move, %.2f M boards/s per thread\n",
+              threads, pool_seconds * 1e6 / kMoves,
+              evaluations / pool_seconds / 1e6 / threads);
+  std::printf("idle frames per piece (60Hz): %.2f, %.2f with a %d ms entry delay\n",
+              idle_frames_per_piece[0], idle_frames_per_piece[1], kEntryDelays[1]);
+  std::printf("mismatches                  : %lld\n", mismatches);
+  return mismatches != 0;
+}
@@ -0,0 +1,92 @@
+// Tetris beam-search planner throughput and memory report.
+//
+// Plays the same seeded game once per beam shape, planning every move over
+// the engine's preview of upcoming pieces, first on one thread and then on one thread
+// per CPU. Reports boards expanded per second, how many states the
+// transposition table merged, and the memory each beam shape holds. The two
+// thread counts must agree on every move, so the report doubles as a
+// determinism check.
+
+#include <chrono>
+#include <cstdio>
+
+#include "../brick_game/tetris/tetris_bot.h"
+
+using namespace s21;
+
+namespace {
+struct Run {
+  double seconds = 0.0;
+  unsigned long long evaluations = 0;
+  unsigned long long transpositions = 0;
+  int lines = 0;
+  long long checksum = 0;  // Folds in every chosen move
+};
+
+// Plays `moves` pieces of a seeded game
+Run play(TetrisBot* bot, int moves) {
+  Run run;
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 99);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  unsigned long long evaluations = tetris_bot_evaluations(bot);
+  unsigned long long transpositions = tetris_bot_transpositions(bot);
+  for (int m = 0; m < moves; ++m) {
+    if (ctx->overall_game_state != GAME_RUNNING) {
+      tetris_input(ctx, Start, false);
+      tetris_step(ctx);
+    }
+    auto start = std::chrono::steady_clock::now();
+    TetrisBotMove move = tetris_bot_plan(bot, ctx, nullptr, 0);
+    run.seconds += std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+    run.checksum = run.checksum * 31 + move.x * 4 + move.rotation;
+    for (int i = 0; i < move.action_count; ++i)
+      tetris_input(ctx, move.actions[i], false);
+    run.lines += tetris_last_clear(ctx)->count;
+  }
+  run.evaluations = tetris_bot_evaluations(bot) - evaluations;
+  run.transpositions = tetris_bot_transpositions(bot) - transpositions;
+  tetris_destroy(ctx);
+  return run;
+}
+}  // namespace
+
+int main() {
+  const int kMoves = 100;
+  const TetrisBotBeam kBeams[] = {
+      {16, 3, 12}, {64, 3, 16}, {64, 5, 16}, {256, 4, 18},
+  };
+  TetrisBot* single = tetris_bot_create(1);
+  TetrisBot* pool = tetris_bot_create(0);
+  int threads = tetris_bot_threads(pool);
+  long long mismatches = 0;
+
+  std::printf("threads in pool             : %d\n", threads);
+  for (const TetrisBotBeam& beam : kBeams) {
+    if (!tetris_bot_set_beam(single, &beam) || !tetris_bot_set_beam(pool, &beam)) {
+      std::printf("beam %d x %d: allocation failed\n", beam.width, beam.depth);
+      return 1;
+    }
+    Run a = play(single, kMoves);
+    Run b = play(pool, kMoves);
+    mismatches += a.checksum != b.checksum;
+    std::printf("beam %3d x %d, 2^%d entries : %7.2f MiB, %5.2f ms/move\n",
+                beam.width, beam.depth, beam.table_bits,
+                static_cast<double>(tetris_bot_memory(single)) / (1 << 20),
+                a.seconds * 1e3 / kMoves);
+    std::printf("  1 thread                  : %.2f M boards/s, %.1f%% merged, %d lines\n",
+                static_cast<double>(a.evaluations) / a.seconds / 1e6,
+                100.0 * static_cast<double>(a.transpositions) /
+                    static_cast<double>(a.evaluations),
+                a.lines);
+    std::printf("  %2d threads                : %.2f M boards/s, %.2f M per thread\n",
+                threads, static_cast<double>(b.evaluations) / b.seconds / 1e6,
+                static_cast<double>(b.evaluations) / b.seconds / 1e6 / threads);
+  }
+  tetris_bot_destroy(pool);
+  tetris_bot_destroy(single);
+  std::printf("mismatches                  : %lld\n", mismatches);
+  return mismatches != 0;
+}
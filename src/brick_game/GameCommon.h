@@ -9,15 +9,19 @@ extern "C" {  // To make C functions linkable from C++ if they were in a .c file
 
 #include <stdbool.h>
 
-// Board dimensions
-const int FIELD_WIDTH = 10;
-const int FIELD_HEIGHT = 20;
+// Board dimensions (enumerators so C code can size arrays with them too)
+enum {
+  FIELD_WIDTH = 10,
+  FIELD_HEIGHT = 20,
 
-const int NEXT_FIELD_WIDTH = 4;
-const int NEXT_FIELD_HEIGHT = 4;
+  NEXT_FIELD_WIDTH = 4,
+  NEXT_FIELD_HEIGHT = 4,
+
+  PREVIEW_LENGTH = 5  // Upcoming pieces a frame can list
+};
 
 // Enums for game elements on the field
-enum CellState { EMPTY = 0, HEAD = 1, BODY = 2, FOOD = 3 };
+enum CellState { EMPTY = 0, HEAD = 1, BODY = 2, FOOD = 3, GHOST = 4 };
 
 // User actions
 typedef enum {
@@ -28,7 +32,9 @@ typedef enum {
   Right,
   Up,
   Down,
-  Action
+  Action,
+  AltAction,  // Rotates counter-clockwise in Tetris; Snake ignores it
+  Autopilot  // Toggles the built-in Tetris bot; Snake ignores it
 } UserAction_t;
 
 // Game states for the Finite State Machine (FSM)
@@ -55,11 +61,91 @@ typedef struct {
   GameState current_game_state;
 } GameInfo_t;
 
+// Engine-owned render frame. info.field/info.next point into the frame's own
+// cell storage, so a frame must not be copied by value; borrow it with
+// borrowCurrentState() and hand it back with releaseCurrentState().
+typedef struct {
+  GameInfo_t info;
+  int *field_rows[FIELD_HEIGHT];
+  int *next_rows[NEXT_FIELD_HEIGHT];
+  int field_cells[FIELD_HEIGHT][FIELD_WIDTH];
+  int next_cells[NEXT_FIELD_HEIGHT][NEXT_FIELD_WIDTH];
+  int landing_row;  // Row the falling piece's lowest block would drop to, -1 if none
+  int preview[PREVIEW_LENGTH];  // Upcoming piece types, soonest first
+  int preview_count;            // Entries of preview in use, 0 if the game has none
+} GameFrame_t;
+
+// Two frames per engine: the engine renders into one while the caller may
+// still be painting the other, so reading state never touches the heap.
+typedef struct {
+  GameFrame_t frames[2];
+  bool borrowed[2];
+  int front;  // Index of the most recently published frame
+} GameFrameBuffer_t;
+
+// Points a frame's GameInfo_t at the frame's own cell storage
+static inline void bindGameFrame(GameFrame_t *frame) {
+  for (int i = 0; i < FIELD_HEIGHT; ++i) {
+    frame->field_rows[i] = frame->field_cells[i];
+  }
+  for (int i = 0; i < NEXT_FIELD_HEIGHT; ++i) {
+    frame->next_rows[i] = frame->next_cells[i];
+  }
+  frame->info.field = frame->field_rows;
+  frame->info.next = frame->next_rows;
+}
+
+// Copies a frame and points the copy at its own cells
+static inline void copyGameFrame(GameFrame_t *dest, const GameFrame_t *src) {
+  *dest = *src;
+  bindGameFrame(dest);
+}
+
+// Binds both frames of a buffer and marks them free
+static inline void initGameFrameBuffer(GameFrameBuffer_t *buffer) {
+  for (int f = 0; f < 2; ++f) {
+    bindGameFrame(&buffer->frames[f]);
+    buffer->borrowed[f] = false;
+  }
+  buffer->front = 0;
+}
+
+// Picks a frame that is not held by the caller, preferring the one that was
+// not published last. Returns NULL if the caller still holds both frames.
+static inline GameFrame_t *acquireGameFrame(GameFrameBuffer_t *buffer) {
+  int back = 1 - buffer->front;
+  if (buffer->borrowed[back]) back = buffer->front;
+  if (buffer->borrowed[back]) return 0;
+  buffer->borrowed[back] = true;
+  buffer->front = back;
+  return &buffer->frames[back];
+}
+
+// Returns a frame obtained from acquireGameFrame() to the engine
+static inline void releaseGameFrame(GameFrameBuffer_t *buffer,
+                                    const GameFrame_t *frame) {
+  for (int f = 0; f < 2; ++f) {
+    if (&buffer->frames[f] == frame) buffer->borrowed[f] = false;
+  }
+}
+
 // Forward declarations for the game API functions
 // These will be implemented in the s21::Game class
 extern void userInput(UserAction_t action, bool hold);
+extern void releaseInput(UserAction_t action);  // The key sent to userInput() went up
 extern GameInfo_t updateCurrentState();
 
+// Zero-allocation variant of updateCurrentState(): advances the game the same
+// way but renders into an engine-owned frame. The frame stays valid until it
+// is passed to releaseCurrentState(); at most two frames can be held at once.
+extern const GameFrame_t *borrowCurrentState();
+extern void releaseCurrentState(const GameFrame_t *frame);
+
+// The same split into its two halves: stepGame() only advances the game by a
+// span of time, borrowSnapshot() only renders (release it the same way).
+extern void stepGame(double seconds);
+extern const GameFrame_t *borrowSnapshot();
+
 #ifdef __cplusplus
 }  // extern "C"
 }  // namespace s21
@@ -4,5 +4,14 @@ namespace s21_controller {
 void userInput(s21::UserAction_t action, bool hold) {
   s21::userInput(action, hold);
 }
+void releaseInput(s21::UserAction_t action) { s21::releaseInput(action); }
 s21::GameInfo_t updateCurrentState() { return s21::updateCurrentState(); }
-}  // namespace s21_controller
\ No newline at end of file
+const s21::GameFrame_t* borrowCurrentState() {
+  return s21::borrowCurrentState();
+}
+void releaseCurrentState(const s21::GameFrame_t* frame) {
+  s21::releaseCurrentState(frame);
+}
+void step(double seconds) { s21::stepGame(seconds); }
+const s21::GameFrame_t* snapshot() { return s21::borrowSnapshot(); }
+}  // namespace s21_controller
@@ -6,7 +6,12 @@
 namespace s21_controller {
 extern void userInput(s21::UserAction_t action,
                       bool hold);  // Pass action to game model
+extern void releaseInput(s21::UserAction_t action);  // Key went up
 extern s21::GameInfo_t updateCurrentState();
+extern const s21::GameFrame_t* borrowCurrentState();  // No heap allocation
+extern void releaseCurrentState(const s21::GameFrame_t* frame);
+extern void step(double seconds);  // Advance the game only
+extern const s21::GameFrame_t* snapshot();  // Render only, no side effects
 }  // namespace s21_controller
 
-#endif  // GAME_CONTROLLER_H_
\ No newline at end of file
+#endif  // GAME_CONTROLLER_H_
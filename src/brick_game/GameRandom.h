@@ -0,0 +1,57 @@
+// src/brick_game/GameRandom.h
+#ifndef S21_BRICK_GAME_RANDOM_H
+#define S21_BRICK_GAME_RANDOM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+namespace s21 {
+extern "C" {
+#endif
+
+// Small per-engine pseudo random generator (PCG32, XSH-RR variant).
+// Each engine owns one, so a seed plus an input stream always reproduces the
+// same game and parallel simulations never contend on libc's rand() lock.
+typedef struct {
+  uint64_t state;
+  uint64_t inc;  // Stream selector, always odd
+} GameRandom_t;
+
+// Returns the next 32 uniformly distributed bits
+static inline uint32_t nextGameRandom(GameRandom_t *rng) {
+  uint64_t old_state = rng->state;
+  rng->state = old_state * 6364136223846793005ULL + rng->inc;
+  uint32_t xorshifted = (uint32_t)(((old_state >> 18u) ^ old_state) >> 27u);
+  uint32_t rot = (uint32_t)(old_state >> 59u);
+  return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31u));
+}
+
+// Resets the generator to the sequence identified by the seed
+static inline void seedGameRandom(GameRandom_t *rng, uint64_t seed) {
+  rng->state = 0;
+  rng->inc = (seed << 1u) | 1u;
+  nextGameRandom(rng);
+  rng->state += seed;
+  nextGameRandom(rng);
+}
+
+// Returns a uniformly distributed value in [0, bound), bound > 0.
+// Multiply-shift with rejection (Lemire), so there is no modulo bias.
+static inline uint32_t boundedGameRandom(GameRandom_t *rng, uint32_t bound) {
+  uint64_t product = (uint64_t)nextGameRandom(rng) * bound;
+  uint32_t low = (uint32_t)product;
+  if (low < bound) {
+    uint32_t threshold = (0u - bound) % bound;
+    while (low < threshold) {
+      product = (uint64_t)nextGameRandom(rng) * bound;
+      low = (uint32_t)product;
+    }
+  }
+  return (uint32_t)(product >> 32u);
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace s21
+#endif
+#endif  // S21_BRICK_GAME_RANDOM_H
@@ -0,0 +1,156 @@
+#include "GameRunner.h"
+
+#include <algorithm>  // For std::min
+
+namespace s21_controller {
+
+// --- JitterStats ---
+
+void JitterStats::record(std::chrono::nanoseconds late) {
+  const std::uint64_t ns = late.count() > 0 ? late.count() : 0;
+  const std::uint64_t bucket =
+      std::min<std::uint64_t>(ns / 1000, static_cast<std::uint64_t>(kBuckets));
+  // Single writer: plain load/store pairs are enough
+  buckets_[bucket].store(buckets_[bucket].load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  ticks_.store(ticks_.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+  total_ns_.store(total_ns_.load(std::memory_order_relaxed) + ns,
+                  std::memory_order_relaxed);
+  if (ns > max_ns_.load(std::memory_order_relaxed)) {
+    max_ns_.store(ns, std::memory_order_relaxed);
+  }
+}
+
+JitterReport JitterStats::report() const {
+  JitterReport report;
+  report.ticks = ticks_.load(std::memory_order_relaxed);
+  if (report.ticks == 0) return report;
+  report.mean_us = total_ns_.load(std::memory_order_relaxed) / 1000.0 /
+                   static_cast<double>(report.ticks);
+  report.max_us = max_ns_.load(std::memory_order_relaxed) / 1000.0;
+
+  const std::uint64_t p50_rank = (report.ticks + 1) / 2;
+  const std::uint64_t p99_rank = (report.ticks * 99 + 99) / 100;
+  // A percentile in the overflow bucket is reported as the maximum
+  auto bucket_us = [&](int b) { return b < kBuckets ? b : report.max_us; };
+  std::uint64_t seen = 0;
+  bool have_p50 = false;
+  for (int b = 0; b <= kBuckets; ++b) {
+    seen += buckets_[b].load(std::memory_order_relaxed);
+    if (!have_p50 && seen >= p50_rank) {
+      report.p50_us = bucket_us(b);
+      have_p50 = true;
+    }
+    if (seen >= p99_rank) {
+      report.p99_us = bucket_us(b);
+      break;
+    }
+  }
+  return report;
+}
+
+void JitterStats::reset() {
+  for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+  ticks_.store(0, std::memory_order_relaxed);
+  total_ns_.store(0, std::memory_order_relaxed);
+  max_ns_.store(0, std::memory_order_relaxed);
+}
+
+// --- StepClock ---
+
+double StepClock::lap(Clock::time_point now) {
+  const double seconds =
+      running_ ? std::chrono::duration<double>(now - last_).count() : 0.0;
+  last_ = now;
+  running_ = true;
+  return seconds;
+}
+
+// --- GameRunner ---
+
+GameRunner::GameRunner(std::chrono::nanoseconds period) : period_(period) {
+  for (auto& frame : frames_) {
+    frame = s21::GameFrame_t{};
+    s21::bindGameFrame(&frame);
+  }
+}
+
+GameRunner::~GameRunner() { stop(); }
+
+void GameRunner::start() {
+  if (running()) return;
+  publish();  // latest() has a frame before the first tick
+  thread_ = std::jthread([this](std::stop_token stop) { run(stop); });
+}
+
+void GameRunner::stop() {
+  if (!running()) return;
+  thread_.request_stop();
+  thread_.join();
+  applyInputs(std::chrono::steady_clock::now());  // Nothing sent is lost
+}
+
+bool GameRunner::userInput(s21::UserAction_t action, bool hold) {
+  return queueInput({action, hold, false, std::chrono::steady_clock::now()});
+}
+
+bool GameRunner::releaseInput(s21::UserAction_t action) {
+  return queueInput({action, false, true, std::chrono::steady_clock::now()});
+}
+
+bool GameRunner::queueInput(const Input& input) {
+  if (inputs_.push(input)) return true;
+  dropped_inputs_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void GameRunner::applyInputs(std::chrono::steady_clock::time_point now) {
+  Input input;
+  while (inputs_.pop(&input)) {
+    input_latency_.record(now - input.sent);
+    if (input.release) {
+      s21::releaseInput(input.action);
+    } else {
+      s21::userInput(input.action, input.hold);
+    }
+  }
+}
+
+void GameRunner::publish() {
+  const s21::GameFrame_t* frame = s21::borrowSnapshot();
+  if (frame == nullptr) return;  // Someone else holds both engine frames
+  s21::copyGameFrame(&frames_[back_], frame);
+  s21::releaseCurrentState(frame);
+  back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & ~kFresh;
+}
+
+const s21::GameFrame_t* GameRunner::latest() {
+  if (middle_.load(std::memory_order_acquire) & kFresh) {
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~kFresh;
+  }
+  return &frames_[front_];
+}
+
+void GameRunner::run(std::stop_token stop) {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point scheduled = Clock::now();
+  Clock::time_point last_tick = scheduled;
+  while (!stop.stop_requested()) {
+    scheduled += period_;
+    std::this_thread::sleep_until(scheduled);
+    const Clock::time_point now = Clock::now();
+    jitter_.record(now - scheduled);
+
+    applyInputs(now);
+    s21::stepGame(std::chrono::duration<double>(now - last_tick).count());
+    last_tick = now;
+    publish();
+
+    // After a stall, skip the missed ticks instead of bursting through them;
+    // the next step still covers the whole elapsed time
+    if (now - scheduled > period_) scheduled = now;
+  }
+}
+
+}  // namespace s21_controller
@@ -0,0 +1,207 @@
+#ifndef S21_BRICK_GAME_RUNNER_H
+#define S21_BRICK_GAME_RUNNER_H
+
+#include <array>    // For the frame slots and jitter histogram
+#include <atomic>   // For the lock-free frame exchange
+#include <chrono>   // For the tick period
+#include <cstdint>  // For the histogram counters
+#include <thread>   // For std::jthread
+
+#include "GameCommon.h"
+#include "SpscQueue.h"
+
+namespace s21_controller {
+
+/**
+ * @brief Summary of how late a runner's ticks started, in microseconds.
+ */
+struct JitterReport {
+  std::uint64_t ticks = 0;  ///< Ticks measured.
+  double mean_us = 0.0;     ///< Mean lateness.
+  double p50_us = 0.0;      ///< Median lateness.
+  double p99_us = 0.0;      ///< 99th percentile lateness.
+  double max_us = 0.0;      ///< Worst lateness.
+};
+
+/**
+ * @brief Histogram of tick lateness against a schedule, or of any other
+ * delay.
+ *
+ * One thread records, any thread may report at the same time; counters are
+ * relaxed atomics, so a report taken mid-run may lag by a tick.
+ */
+class JitterStats {
+ public:
+  /// Lateness is binned per microsecond up to this many microseconds.
+  static constexpr int kBuckets = 10000;
+
+  /**
+   * @brief Records the lateness of one tick.
+   * @param late How long after its scheduled time the tick started.
+   */
+  void record(std::chrono::nanoseconds late);
+
+  /**
+   * @brief Summarizes everything recorded so far.
+   * @return The report; percentiles have microsecond resolution, and read as
+   * the maximum once they pass kBuckets.
+   */
+  JitterReport report() const;
+
+  /**
+   * @brief Forgets everything recorded so far. Not safe during record().
+   */
+  void reset();
+
+ private:
+  std::array<std::atomic<std::uint32_t>, kBuckets + 1> buckets_{};
+  std::atomic<std::uint64_t> ticks_{0};
+  std::atomic<std::uint64_t> total_ns_{0};
+  std::atomic<std::uint64_t> max_ns_{0};
+};
+
+/**
+ * @brief Turns a frontend loop's clock readings into game time.
+ *
+ * A loop that stops stepping while the game waits for a key (start screen,
+ * pause, game over) calls stop(); the wait then does not count, and the
+ * first lap() after it hands the game no time at all.
+ */
+class StepClock {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Seconds since the previous lap, or 0 for the first lap after
+   * construction or stop().
+   * @param now Current reading of the clock.
+   */
+  double lap(Clock::time_point now);
+
+  /**
+   * @brief Marks time from now until the next lap() as not game time.
+   */
+  void stop() { running_ = false; }
+
+ private:
+  Clock::time_point last_{};
+  bool running_ = false;
+};
+
+/**
+ * @brief Runs the game of the global API on its own thread.
+ *
+ * The thread steps the game on a steady clock, independently of how long the
+ * frontend spends painting, and publishes every tick's frame through a
+ * triple buffer: the frontend always gets the newest complete frame without
+ * waiting, and the runner never waits for the frontend. While the runner is
+ * started it owns the game; send input through it instead of calling the
+ * global API directly. Input travels through a lock-free queue, stamped with
+ * the time it was sent, and every event is applied in order at the start of
+ * the next tick. One thread sends input and one thread reads frames; it may
+ * be the same thread.
+ */
+class GameRunner {
+ public:
+  /**
+   * @brief Creates a stopped runner.
+   * @param period Time between ticks.
+   */
+  explicit GameRunner(
+      std::chrono::nanoseconds period = std::chrono::milliseconds(10));
+
+  /**
+   * @brief Stops the thread if it is running.
+   */
+  ~GameRunner();
+
+  GameRunner(const GameRunner&) = delete;
+  GameRunner& operator=(const GameRunner&) = delete;
+
+  /**
+   * @brief Publishes the current frame and starts ticking.
+   */
+  void start();
+
+  /**
+   * @brief Stops ticking and joins the thread; the game stays where it is.
+   */
+  void stop();
+
+  /**
+   * @brief Whether the thread is running.
+   */
+  bool running() const { return thread_.joinable(); }
+
+  /**
+   * @brief Queues a key press for the next tick (see s21::userInput()).
+   * @return false if the queue was full and the press was dropped.
+   */
+  bool userInput(s21::UserAction_t action, bool hold);
+
+  /**
+   * @brief Queues a key release for the next tick (see s21::releaseInput()).
+   * @return false if the queue was full and the release was dropped.
+   */
+  bool releaseInput(s21::UserAction_t action);
+
+  /**
+   * @brief The newest published frame. Wait-free; one reader only.
+   * @return Frame valid until the next call; never nullptr after start().
+   */
+  const s21::GameFrame_t* latest();
+
+  /**
+   * @brief How late the ticks started relative to their schedule.
+   */
+  JitterReport jitterReport() const { return jitter_.report(); }
+
+  /**
+   * @brief How long input events waited for the tick that applied them.
+   */
+  JitterReport inputLatencyReport() const { return input_latency_.report(); }
+
+  /**
+   * @brief Input events dropped because the queue was full.
+   */
+  std::uint64_t droppedInputs() const {
+    return dropped_inputs_.load(std::memory_order_relaxed);
+  }
+
+  /// Input events that can wait for one tick; more are dropped.
+  static constexpr std::size_t kInputCapacity = 256;
+
+ private:
+  struct Input {
+    s21::UserAction_t action;
+    bool hold;
+    bool release;
+    std::chrono::steady_clock::time_point sent;
+  };
+
+  // Slot exchange word: index of the middle slot, plus kFresh if it holds a
+  // frame the reader has not taken yet
+  static constexpr unsigned kFresh = 4;
+
+  void run(std::stop_token stop);
+  bool queueInput(const Input& input);
+  void applyInputs(std::chrono::steady_clock::time_point now);
+  void publish();
+
+  std::chrono::nanoseconds period_;
+  std::array<s21::GameFrame_t, 3> frames_;
+  unsigned back_ = 0;   ///< Slot the runner writes, owned by the runner.
+  unsigned front_ = 2;  ///< Slot the reader holds, owned by the reader.
+  std::atomic<unsigned> middle_{1};
+
+  s21::SpscQueue<Input, kInputCapacity> inputs_;
+  std::atomic<std::uint64_t> dropped_inputs_{0};
+
+  JitterStats jitter_;
+  JitterStats input_latency_;
+  std::jthread thread_;
+};
+
+}  // namespace s21_controller
+
+#endif  // S21_BRICK_GAME_RUNNER_H
@@ -0,0 +1,76 @@
+#ifndef S21_BRICK_GAME_SPSC_QUEUE_H
+#define S21_BRICK_GAME_SPSC_QUEUE_H
+
+#include <array>    // For the preallocated slots
+#include <atomic>   // For the head and tail indexes
+#include <cstddef>  // For std::size_t
+
+namespace s21 {
+
+/**
+ * @brief Bounded lock-free queue for one producer and one consumer thread.
+ *
+ * Slots live inline in the object, so neither side ever allocates, locks or
+ * waits. Each side caches the other side's index and only rereads it when
+ * the queue looks full (producer) or empty (consumer).
+ *
+ * @tparam T Element type, copied in and out.
+ * @tparam Capacity Maximum number of queued elements, a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+ public:
+  /**
+   * @brief Appends an element. Producer thread only.
+   * @param value The element to append.
+   * @return false, leaving the queue unchanged, if it is full.
+   */
+  bool push(const T& value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == Capacity) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == Capacity) return false;
+    }
+    slots_[tail & (Capacity - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest element. Consumer thread only.
+   * @param value Receives the element.
+   * @return false, leaving value untouched, if the queue is empty.
+   */
+  bool pop(T* value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) return false;
+    }
+    *value = slots_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Maximum number of queued elements.
+   * @return The capacity.
+   */
+  static constexpr std::size_t capacity() { return Capacity; }
+
+ private:
+  // Each side's index shares a cache line only with that side's cache of
+  // the other index
+  alignas(64) std::atomic<std::size_t> head_{0};  ///< Next slot to pop.
+  std::size_t tail_cache_ = 0;  ///< Consumer's last reading of tail_.
+  alignas(64) std::atomic<std::size_t> tail_{0};  ///< Next slot to push.
+  std::size_t head_cache_ = 0;  ///< Producer's last reading of head_.
+  alignas(64) std::array<T, Capacity> slots_{};
+};
+
+}  // namespace s21
+
+#endif  // S21_BRICK_GAME_SPSC_QUEUE_H
@@ -0,0 +1,102 @@
+#ifndef S21_BRICK_GAME_SNAKE_RING_BUFFER_H
+#define S21_BRICK_GAME_SNAKE_RING_BUFFER_H
+
+#include <array>    // For the preallocated storage
+#include <cstddef>  // For std::size_t
+
+namespace s21 {
+
+/**
+ * @brief Fixed-capacity double-ended ring buffer.
+ *
+ * Storage lives inline in the object, so pushing and popping never touch the
+ * heap. Supports the deque operations the Snake body needs: push at the
+ * front (new head), pop at the back (tail) and indexed access from the front.
+ *
+ * @tparam T Element type.
+ * @tparam Capacity Maximum number of elements.
+ */
+template <typename T, std::size_t Capacity>
+class RingBuffer {
+ public:
+  /**
+   * @brief Removes all elements.
+   */
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /**
+   * @brief Number of stored elements.
+   * @return The element count.
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Maximum number of elements the buffer can hold.
+   * @return The capacity.
+   */
+  static constexpr std::size_t capacity() { return Capacity; }
+
+  /**
+   * @brief Inserts an element before the first one. Buffer must not be full.
+   * @param value The element to insert.
+   */
+  void push_front(T value) {
+    head_ = head_ == 0 ? Capacity - 1 : head_ - 1;
+    data_[head_] = value;
+    ++size_;
+  }
+
+  /**
+   * @brief Appends an element after the last one. Buffer must not be full.
+   * @param value The element to append.
+   */
+  void push_back(T value) {
+    data_[wrap(head_ + size_)] = value;
+    ++size_;
+  }
+
+  /**
+   * @brief Removes the last element. Buffer must not be empty.
+   */
+  void pop_back() { --size_; }
+
+  /**
+   * @brief First element. Buffer must not be empty.
+   * @return The first element.
+   */
+  T front() const { return data_[head_]; }
+
+  /**
+   * @brief Last element. Buffer must not be empty.
+   * @return The last element.
+   */
+  T back() const { return data_[wrap(head_ + size_ - 1)]; }
+
+  /**
+   * @brief Element at a position counted from the front.
+   * @param index Position, 0 being the front.
+   * @return The element.
+   */
+  T operator[](std::size_t index) const { return data_[wrap(head_ + index)]; }
+
+ private:
+  /**
+   * @brief Maps a position in [0, 2 * Capacity) onto the storage.
+   * @param index The unwrapped position.
+   * @return The storage index.
+   */
+  static std::size_t wrap(std::size_t index) {
+    return index >= Capacity ? index - Capacity : index;
+  }
+
+  std::array<T, Capacity> data_{};  ///< Preallocated element storage.
+  std::size_t head_ = 0;            ///< Storage index of the front element.
+  std::size_t size_ = 0;            ///< Number of stored elements.
+};
+
+}  // namespace s21
+
+#endif  // S21_BRICK_GAME_SNAKE_RING_BUFFER_H
@@ -1,161 +1,204 @@
 #include "snake.h"
 
-#include <algorithm>  // For std::max, std::any_of
+#include <algorithm>  // For std::max, std::copy_n, std::fill
 #include <chrono>     // For random seed
 #include <fstream>    // For file I/O for high score
+#include <iterator>   // For std::begin, std::end
 
 namespace s21 {
 
+namespace {
+constexpr double kTimeEpsilon = 1e-9;  // Absorbs rounding of summed slices
+// Longest span one step() simulates, so a stalled caller does not come back
+// to a snake that replayed seconds of moves
+constexpr double kMaxStepSeconds = 1.0;
+}  // namespace
+
 // --- Global API Functions (as per specification) ---
+// Thin adapters over the default engine instance.
 
 void userInput(UserAction_t action, bool hold) {
-  (void)hold;
-  Game::getInstance().handleUserInput(action, hold);
+  SnakeEngine::getInstance().handleUserInput(action, hold);
+}
+
+void releaseInput(UserAction_t action) {
+  SnakeEngine::getInstance().handleUserRelease(action);
 }
 
 GameInfo_t updateCurrentState() {
-  return Game::getInstance().getCurrentState();
+  return SnakeEngine::getInstance().getCurrentState();
 }
 
-// --- Game Class Implementation ---
+const GameFrame_t* borrowCurrentState() {
+  return SnakeEngine::getInstance().borrowState();
+}
 
-Game& Game::getInstance() {
-  static Game instance;
-  return instance;
+void releaseCurrentState(const GameFrame_t* frame) {
+  SnakeEngine::getInstance().releaseState(frame);
 }
 
-Game::Game()
-    : current_state_(START_SCREEN),
-      score_(0),
-      high_score_(0),
-      level_(1),
-      speed_(500),  // Initial speed: 500 ms update interval
-      snake_direction_({1, 0}) {
-  // Initialize random seed
-  srand(static_cast<unsigned int>(
-      std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::system_clock::now().time_since_epoch())
-          .count()));
+void stepGame(double seconds) { SnakeEngine::getInstance().step(seconds); }
 
-  loadHighScore();   // Load high score on game initialization
-  initializeGame();  // Set up initial game state
+const GameFrame_t* borrowSnapshot() {
+  return SnakeEngine::getInstance().snapshot();
 }
 
-Game::~Game() {
-  saveHighScore();  // Save high score on game exit
+// --- High Score Sinks ---
 
-  // Remember to deallocate memory when done
-  for (int i = 0; i < FIELD_HEIGHT; ++i) {
-    delete[] game_field_[i];
+int FileHighScoreSink::load() {
+  int high_score = 0;
+  std::ifstream file(path_);
+  if (file.is_open() && !(file >> high_score)) {
+    high_score = 0;
   }
-  delete[] game_field_;
+  return high_score;
+}
 
-  for (int i = 0; i < 4; ++i) {
-    delete[] next_field_[i];
+void FileHighScoreSink::save(int high_score) {
+  std::ofstream file(path_);
+  if (file.is_open()) {
+    file << high_score;
   }
-  delete[] next_field_;
 }
 
-void Game::initializeGame() {
-  // Deallocate existing memory if it's already allocated (e.g., on reset)
-  // Check if game_field_ is not nullptr before attempting to delete
-  if (game_field_ != nullptr) {
-    for (int i = 0; i < FIELD_HEIGHT; ++i) {
-      delete[] game_field_[i];
-    }
-    delete[] game_field_;
-    game_field_ = nullptr;  // Set to nullptr after deallocation
-  }
+// --- SnakeEngine Class Implementation ---
 
-  if (next_field_ != nullptr) {
-    for (int i = 0; i < 4; ++i) {
-      delete[] next_field_[i];
-    }
-    delete[] next_field_;
-    next_field_ = nullptr;  // Set to nullptr after deallocation
-  }
+SnakeEngine& SnakeEngine::getInstance() {
+  static SnakeEngine instance;
+  return instance;
+}
 
-  // Initialize the game field with empty cells
-  game_field_ = new int*[FIELD_HEIGHT];
+SnakeEngine::SnakeEngine()
+    : SnakeEngine(std::make_unique<FileHighScoreSink>("high_score.txt")) {}
 
-  // Allocate memory for each row (FIELD_WIDTH)
-  for (int i = 0; i < FIELD_HEIGHT; ++i) {
-    game_field_[i] = new int[FIELD_WIDTH];
-  }
+// Seeds the per-instance generator from the clock
+SnakeEngine::SnakeEngine(std::unique_ptr<HighScoreSink> high_score_sink)
+    : SnakeEngine(std::move(high_score_sink),
+                  static_cast<std::uint64_t>(
+                      std::chrono::system_clock::now().time_since_epoch()
+                          .count())) {}
 
-  // Initialize the elements (e.g., to 0)
-  for (int i = 0; i < FIELD_HEIGHT; ++i) {
-    for (int j = 0; j < FIELD_WIDTH; ++j) {
-      game_field_[i][j] = 0;  // Initialize each element
-    }
-  }
+SnakeEngine::SnakeEngine(std::unique_ptr<HighScoreSink> high_score_sink,
+                         std::uint64_t seed)
+    : current_state_(START_SCREEN),
+      high_score_sink_(std::move(high_score_sink)),
+      rng_(),
+      food_position_({0, 0}),
+      score_(0),
+      high_score_(0),
+      level_(1),
+      speed_(500),  // Initial speed: 500 ms update interval
+      move_time_(0.0),
+      snake_direction_({1, 0}),
+      boost_held_(false),
+      boost_held_for_(0.0),
+      boost_next_repeat_(0.0),
+      boost_delay_ms_(kDefaultBoostDelayMs),
+      boost_repeat_ms_(kDefaultBoostRepeatMs),
+      free_count_(0) {
+  initGameFrameBuffer(&frame_buffer_);
+  seedGameRandom(&rng_, seed);
 
-  next_field_ = new int*[4];
+  loadHighScore();   // Load high score on game initialization
+  initializeGame();  // Set up initial game state
+}
 
-  // Allocate memory for each row (4)
-  for (int i = 0; i < 4; ++i) {
-    next_field_[i] = new int[4];
-  }
+SnakeEngine::~SnakeEngine() {
+  saveHighScore();  // Save high score on game exit
+}
 
-  // Initialize the elements (e.g., to 0)
-  for (int i = 0; i < 4; ++i) {
-    for (int j = 0; j < 4; ++j) {
-      next_field_[i][j] = 0;  // Initialize each element
-    }
+void SnakeEngine::initializeGame() {
+  // The field, the body and the cell indexes all live inline in the object,
+  // so (re)initializing never allocates.
+  for (auto& row : game_field_) {
+    std::fill(std::begin(row), std::end(row), EMPTY);
+  }
+  for (auto& row : next_field_) {
+    std::fill(std::begin(row), std::end(row), EMPTY);
   }
 
   // Initialize snake (4 segments, starting horizontally near the center)
   snake_.clear();
+  resetFreeCells();
   // Snake starts moving right, so its body segments should be to its left
-  snake_.push_back({FIELD_WIDTH / 2, FIELD_HEIGHT / 2});  // Head
-  snake_.push_back({FIELD_WIDTH / 2 - 1, FIELD_HEIGHT / 2});
-  snake_.push_back({FIELD_WIDTH / 2 - 2, FIELD_HEIGHT / 2});
-  snake_.push_back({FIELD_WIDTH / 2 - 3, FIELD_HEIGHT / 2});
+  for (int i = 0; i < 4; ++i) {
+    Cell segment = cellIndex({FIELD_WIDTH / 2 - i, FIELD_HEIGHT / 2});
+    snake_.push_back(segment);
+    occupyCell(segment);
+  }
 
   // Reset initial direction to right
   snake_direction_ = {1, 0};
+  move_time_ = 0.0;
 
   // Place snake on the field
-  game_field_[snake_.front().y][snake_.front().x] = HEAD;
+  Point head = cellPoint(snake_.front());
+  game_field_[head.y][head.x] = HEAD;
   for (size_t i = 1; i < snake_.size(); ++i) {
-    game_field_[snake_[i].y][snake_[i].x] = BODY;
+    Point segment = cellPoint(snake_[i]);
+    game_field_[segment.y][segment.x] = BODY;
   }
 
   generateFood();  // Place initial food
 }
 
-void Game::resetGame() {
+void SnakeEngine::resetGame() {
   score_ = 0;
   level_ = 1;
   speed_ = 500;                   // Reset to initial speed
+  boost_held_ = false;            // A key held into the next game is forgotten
   initializeGame();               // This will also reset snake_direction_
   current_state_ = START_SCREEN;  // Go back to start screen after reset
 }
 
-void Game::generateFood() {
-  bool placed = false;
-  while (!placed) {
-    int food_x, food_y;
-    food_x = rand() % FIELD_WIDTH;
-    food_y = rand() % FIELD_HEIGHT;
+void SnakeEngine::seed(std::uint64_t seed) {
+  seedGameRandom(&rng_, seed);
+  resetGame();
+}
 
-    // Check if the random position is not occupied by the snake
-    bool occupied =
-        std::any_of(snake_.begin(), snake_.end(), [&](const Point& segment) {
-          return segment.x == food_x && segment.y == food_y;
-        });
+void SnakeEngine::generateFood() {
+  // Every free cell is a valid food position, so one draw is always enough
+  if (free_count_ == 0) {
+    return;
+  }
+  food_position_ = cellPoint(free_cells_[boundedGameRandom(
+      &rng_, static_cast<std::uint32_t>(free_count_))]);
+  game_field_[food_position_.y][food_position_.x] = FOOD;
+}
 
-    if (!occupied) {
-      food_position_ = {food_x, food_y};
-      game_field_[food_y][food_x] = FOOD;
-      placed = true;
-    }
+void SnakeEngine::resetFreeCells() {
+  occupied_.reset();
+  for (int cell = 0; cell < kCellCount; ++cell) {
+    free_cells_[cell] = static_cast<Cell>(cell);
+    free_slot_[cell] = static_cast<Cell>(cell);
   }
+  free_count_ = kCellCount;
+}
+
+void SnakeEngine::occupyCell(Cell cell) {
+  // Swap-remove: move the last free cell into the vacated slot
+  occupied_.set(cell);
+  Cell slot = free_slot_[cell];
+  Cell last = free_cells_[--free_count_];
+  free_cells_[slot] = last;
+  free_slot_[last] = slot;
+  free_cells_[free_count_] = cell;
+  free_slot_[cell] = static_cast<Cell>(free_count_);
 }
 
-void Game::moveSnake() {
+void SnakeEngine::vacateCell(Cell cell) {
+  occupied_.reset(cell);
+  Cell slot = free_slot_[cell];
+  Cell first_used = free_cells_[free_count_];
+  free_cells_[slot] = first_used;
+  free_slot_[first_used] = slot;
+  free_cells_[free_count_] = cell;
+  free_slot_[cell] = static_cast<Cell>(free_count_++);
+}
+
+void SnakeEngine::moveSnake() {
   // Check if food is eaten first, as this might change the tail behavior
-  Point old_head = snake_.front();
+  Point old_head = cellPoint(snake_.front());
   Point new_head = old_head + snake_direction_;  // Use overloaded + operator
 
   // Check for collision before moving the snake
@@ -166,32 +209,29 @@ void Game::moveSnake() {
     return;
   }
 
-  // Self-collision (check new head against existing body, excluding potential
-  // tail) If food is eaten, the tail doesn't move, so new head might collide
-  // with old tail. If not, the tail moves, so new head shouldn't collide with
-  // the space the tail just vacated.
-  bool food_eaten =
-      (new_head.x == food_position_.x && new_head.y == food_position_.y);
-
-  // Iterate over snake body, but exclude the very last segment if food is NOT
-  // eaten because that segment will be moved.
-  for (size_t i = 0; i < snake_.size() - (food_eaten ? 0 : 1); ++i) {
-    if (new_head == snake_[i]) {  // Using overloaded == operator
-      current_state_ = GAME_OVER_LOSE;
-      return;
-    }
+  // Self-collision: a single bit test against the occupancy bitboard. If food
+  // is not eaten the tail moves away this tick, so the head may enter the
+  // cell the tail is vacating.
+  bool food_eaten = new_head == food_position_;
+  Cell new_cell = cellIndex(new_head);
+  if (occupied_.test(new_cell) && (food_eaten || new_cell != snake_.back())) {
+    current_state_ = GAME_OVER_LOSE;
+    return;
   }
 
   // Update game field and snake body
   // Clear the old tail's position *if* it's moving
   if (!food_eaten) {
-    Point tail = snake_.back();
-    game_field_[tail.y][tail.x] = EMPTY;
+    Cell tail = snake_.back();
+    Point tail_point = cellPoint(tail);
+    game_field_[tail_point.y][tail_point.x] = EMPTY;
     snake_.pop_back();
+    vacateCell(tail);
   }
 
   // Add new head
-  snake_.push_front(new_head);
+  snake_.push_front(new_cell);
+  occupyCell(new_cell);
   game_field_[new_head.y][new_head.x] = HEAD;
   game_field_[old_head.y][old_head.x] = BODY;  // Old head becomes body
 
@@ -215,15 +255,17 @@ void Game::moveSnake() {
   }
 }
 
-void Game::increaseSnakeSpeed() {
+void SnakeEngine::increaseSnakeSpeed() {
   speed_ = std::max(
       100, speed_ - 40);  // Minimum speed 100ms, decrease by 40ms per level
 }
 
 // --- FSM and Game Logic Update Functions ---
 
-void Game::handleUserInput(UserAction_t action, bool hold) {
-  (void)hold;
+void SnakeEngine::handleUserInput(UserAction_t action, bool hold) {
+  // OS key repeats are ignored: a held boost repeats from step() on the
+  // engine's own timing, and a held turn must not spin the snake around
+  if (hold) return;
 
   switch (current_state_) {
     case START_SCREEN:
@@ -260,8 +302,12 @@ void Game::handleUserInput(UserAction_t action, bool hold) {
           snake_direction_ = {-snake_direction_.y, 0};
         }
       } else if (action == Action) {
-        // 'Action' button for speeding up snake movement
+        // 'Action' button for speeding up snake movement; while it is held,
+        // step() repeats the boost after boost_delay_ms_
         moveSnake();
+        boost_held_ = true;
+        boost_held_for_ = 0.0;
+        boost_next_repeat_ = boost_delay_ms_ / 1000.0;
       }
       break;
     case PAUSED:
@@ -286,7 +332,16 @@ void Game::handleUserInput(UserAction_t action, bool hold) {
   }
 }
 
-void Game::updateGameLogic() {
+void SnakeEngine::handleUserRelease(UserAction_t action) {
+  if (action == Action) boost_held_ = false;
+}
+
+void SnakeEngine::setAutoRepeat(int delay_ms, int repeat_ms) {
+  boost_delay_ms_ = std::max(0, delay_ms);
+  boost_repeat_ms_ = std::max(1, repeat_ms);
+}
+
+void SnakeEngine::updateGameLogic() {
   // This function is called periodically by the GUI's QTimer
   // It updates the game state based on the current FSM state.
   if (current_state_ == GAME_RUNNING) {
@@ -294,58 +349,99 @@ void Game::updateGameLogic() {
   }
 }
 
-GameInfo_t Game::getCurrentState() {
-  // This function is called by the GUI to get information for rendering.
-  // It also triggers the game logic update if needed.
-  updateGameLogic();  // Update game logic before providing the state
-
-  GameInfo_t info;
+GameInfo_t SnakeEngine::getCurrentState() {
+  // Compatibility path: same update as borrowState(), but the caller gets
+  // its own heap copy of the field and next arrays.
+  const GameFrame_t* frame = borrowState();
+  if (frame == nullptr) {
+    return GameInfo_t{};  // Caller is still holding both frames
+  }
+  GameInfo_t info = frame->info;
 
-  // Allocate and copy the main field
   info.field = new int*[FIELD_HEIGHT];
   for (int i = 0; i < FIELD_HEIGHT; ++i) {
     info.field[i] = new int[FIELD_WIDTH];
-    for (int j = 0; j < FIELD_WIDTH; ++j) {
-      info.field[i][j] = game_field_[i][j];
-    }
+    std::copy_n(frame->field_cells[i], FIELD_WIDTH, info.field[i]);
   }
 
-  // Allocate and copy the next field (not used for Snake, but must not be
-  // nullptr)
-  info.next = new int*[4];
-  for (int i = 0; i < 4; ++i) {
-    info.next[i] = new int[4];
-    for (int j = 0; j < 4; ++j) {
-      info.next[i][j] = next_field_[i][j];
-    }
+  info.next = new int*[NEXT_FIELD_HEIGHT];
+  for (int i = 0; i < NEXT_FIELD_HEIGHT; ++i) {
+    info.next[i] = new int[NEXT_FIELD_WIDTH];
+    std::copy_n(frame->next_cells[i], NEXT_FIELD_WIDTH, info.next[i]);
+  }
+
+  releaseState(frame);
+  return info;
+}
+
+const GameFrame_t* SnakeEngine::borrowState() {
+  // Compatibility path: one move per call, then the frame
+  updateGameLogic();
+  return snapshot();
+}
+
+void SnakeEngine::step(double seconds) {
+  if (current_state_ != GAME_RUNNING) return;
+  seconds = std::min(seconds, kMaxStepSeconds);
+  repeatBoost(seconds);
+  move_time_ += seconds;
+  while (current_state_ == GAME_RUNNING &&
+         move_time_ >= speed_ / 1000.0 - kTimeEpsilon) {
+    move_time_ -= speed_ / 1000.0;  // speed_ may drop on a level up
+    moveSnake();
+  }
+}
+
+void SnakeEngine::repeatBoost(double seconds) {
+  if (!boost_held_) return;
+  boost_held_for_ += seconds;
+  while (current_state_ == GAME_RUNNING &&
+         boost_held_for_ >= boost_next_repeat_ - kTimeEpsilon) {
+    boost_next_repeat_ += boost_repeat_ms_ / 1000.0;
+    moveSnake();
+  }
+}
+
+const GameFrame_t* SnakeEngine::snapshot() {
+  GameFrame_t* frame = acquireGameFrame(&frame_buffer_);
+  if (frame != nullptr) {
+    renderFrame(frame);
+  }
+  return frame;
+}
+
+void SnakeEngine::releaseState(const GameFrame_t* frame) {
+  releaseGameFrame(&frame_buffer_, frame);
+}
+
+void SnakeEngine::renderFrame(GameFrame_t* frame) const {
+  for (int i = 0; i < FIELD_HEIGHT; ++i) {
+    std::copy_n(game_field_[i], FIELD_WIDTH, frame->field_cells[i]);
+  }
+  // The next field is not used for Snake, but must be valid for the GUI
+  for (int i = 0; i < NEXT_FIELD_HEIGHT; ++i) {
+    std::copy_n(next_field_[i], NEXT_FIELD_WIDTH, frame->next_cells[i]);
   }
 
+  GameInfo_t& info = frame->info;
   info.score = score_;
   info.high_score = high_score_;
   info.level = level_;
   info.speed = speed_;  // Speed in milliseconds, tells GUI how fast to tick
   info.pause = (current_state_ == PAUSED) ? 1 : 0;
   info.current_game_state = current_state_;
-
-  return info;
+  frame->landing_row = -1;  // Nothing falls in Snake
+  frame->preview_count = 0;
 }
 
-void Game::loadHighScore() {
-  std::ifstream file(kHighScoreFilePath);
-  if (file.is_open()) {
-    file >> high_score_;
-    file.close();
-  } else {
-    high_score_ = 0;
-  }
+void SnakeEngine::setHighScoreSink(
+    std::unique_ptr<HighScoreSink> high_score_sink) {
+  high_score_sink_ = std::move(high_score_sink);
+  loadHighScore();
 }
 
-void Game::saveHighScore() {
-  std::ofstream file(kHighScoreFilePath);
-  if (file.is_open()) {
-    file << high_score_;
-    file.close();
-  }
-}
+void SnakeEngine::loadHighScore() { high_score_ = high_score_sink_->load(); }
+
+void SnakeEngine::saveHighScore() { high_score_sink_->save(high_score_); }
 
-}  // namespace s21
\ No newline at end of file
+}  // namespace s21
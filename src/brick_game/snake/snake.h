@@ -1,18 +1,23 @@
 #ifndef S21_BRICK_GAME_SNAKE_GAME_H
 #define S21_BRICK_GAME_SNAKE_GAME_H
 
-#include <deque>   // For snake body segments
-#include <random>  // For random food generation
-#include <string>  // For high score file path
+#include <array>    // For the free-cell index
+#include <bitset>   // For the occupancy bitboard
+#include <cstdint>  // For the compact cell index
+#include <memory>   // For the high score sink
+#include <string>   // For high score file path
+#include <utility>  // For std::move
 
 #include "../GameCommon.h"  // Include common definitions
+#include "../GameRandom.h"  // For random food generation
+#include "ring_buffer.h"    // For snake body segments
 
 namespace s21 {
 
 /**
- * @brief Forward declaration of the Game class.
+ * @brief Forward declaration of the SnakeEngine class.
  */
-class Game;
+class SnakeEngine;
 
 /**
  * @brief Handles user input for the Snake game.
@@ -22,6 +27,13 @@ class Game;
  */
 void userInput(UserAction_t action, bool hold);
 
+/**
+ * @brief Reports a key release; releasing Action ends a held speed boost.
+ *
+ * @param action The released action.
+ */
+void releaseInput(UserAction_t action);
+
 /**
  * @brief Updates and retrieves the current state of the Snake game.
  *
@@ -29,6 +41,34 @@ void userInput(UserAction_t action, bool hold);
  */
 GameInfo_t updateCurrentState();
 
+/**
+ * @brief Updates the game and renders it into an engine-owned frame.
+ *
+ * @return const GameFrame_t* Frame valid until releaseCurrentState().
+ */
+const GameFrame_t* borrowCurrentState();
+
+/**
+ * @brief Returns a frame obtained from borrowCurrentState() to the engine.
+ *
+ * @param frame The frame to release.
+ */
+void releaseCurrentState(const GameFrame_t* frame);
+
+/**
+ * @brief Advances the Snake game by a span of time.
+ *
+ * @param seconds Time elapsed since the previous step.
+ */
+void stepGame(double seconds);
+
+/**
+ * @brief Renders the Snake game without advancing it.
+ *
+ * @return const GameFrame_t* Frame valid until releaseCurrentState().
+ */
+const GameFrame_t* borrowSnapshot();
+
 /**
  * @brief Represents a point (x, y) on the game field.
  */
@@ -55,68 +95,240 @@ struct Point {
 };
 
 /**
- * @brief The main Snake game logic and state manager (Singleton).
+ * @brief Persistent storage for the Snake high score.
+ *
+ * Each engine owns its sink, so simulations can swap the file for memory.
+ */
+class HighScoreSink {
+ public:
+  virtual ~HighScoreSink() = default;
+
+  /**
+   * @brief Loads the stored high score.
+   * @return The high score, 0 if nothing is stored.
+   */
+  virtual int load() = 0;
+
+  /**
+   * @brief Stores a new high score.
+   * @param high_score The value to store.
+   */
+  virtual void save(int high_score) = 0;
+};
+
+/**
+ * @brief High score sink backed by a text file.
+ */
+class FileHighScoreSink : public HighScoreSink {
+ public:
+  /**
+   * @brief Constructs a sink reading and writing the given file.
+   * @param path Path of the high score file.
+   */
+  explicit FileHighScoreSink(std::string path) : path_(std::move(path)) {}
+
+  int load() override;
+  void save(int high_score) override;
+
+ private:
+  std::string path_;  ///< Path of the high score file.
+};
+
+/**
+ * @brief High score sink kept in memory, for bots, tests and simulations.
+ */
+class MemoryHighScoreSink : public HighScoreSink {
+ public:
+  int load() override { return high_score_; }
+  void save(int high_score) override { high_score_ = high_score; }
+
+ private:
+  int high_score_ = 0;  ///< Last saved high score.
+};
+
+/**
+ * @brief The main Snake game logic and state manager.
  *
  * This class encapsulates all game logic, state, and data for the Snake game.
- * It uses the singleton pattern to ensure only one instance exists.
+ * Every instance is independent (own field, RNG and high score sink), so many
+ * games can run side by side, including on different threads. The global API
+ * functions drive a default instance.
  */
-class Game {
+class SnakeEngine {
  public:
   /**
-   * @brief Retrieves the singleton instance of the Snake game.
-   * @return Reference to the Game instance.
+   * @brief Constructs an engine that stores its high score in a file.
+   */
+  SnakeEngine();
+
+  /**
+   * @brief Constructs an engine with a custom high score sink.
+   * @param high_score_sink Where the high score is loaded from and saved to.
+   */
+  explicit SnakeEngine(std::unique_ptr<HighScoreSink> high_score_sink);
+
+  /**
+   * @brief Constructs a reproducible engine: the same seed and the same
+   * input stream always produce the same game.
+   * @param high_score_sink Where the high score is loaded from and saved to.
+   * @param seed Seed of the food placement generator.
    */
-  static Game& getInstance();
+  SnakeEngine(std::unique_ptr<HighScoreSink> high_score_sink,
+              std::uint64_t seed);
 
-  // Delete copy constructor and assignment operator for singleton
-  Game(const Game&) = delete;
-  Game& operator=(const Game&) = delete;
+  /**
+   * @brief Destructor, saves the high score.
+   */
+  ~SnakeEngine();
+
+  // Frames point into the engine itself, so it can be neither copied nor moved
+  SnakeEngine(const SnakeEngine&) = delete;
+  SnakeEngine& operator=(const SnakeEngine&) = delete;
+
+  /// Hold before a held Action boost starts repeating, see setAutoRepeat().
+  static constexpr int kDefaultBoostDelayMs = 167;
+  /// Interval between repeated boost moves.
+  static constexpr int kDefaultBoostRepeatMs = 50;
+
+  /**
+   * @brief Retrieves the default instance driven by the global API.
+   * @return Reference to the default engine.
+   */
+  static SnakeEngine& getInstance();
 
   /**
    * @brief Handles user input and updates internal state accordingly.
    * @param action The user action (direction, pause, etc).
-   * @param hold Whether the action is being held down.
+   * @param hold Whether the action is an OS key repeat. Repeats are ignored:
+   * a pressed Action boosts once and, until handleUserRelease(), keeps
+   * boosting from step() as set by setAutoRepeat().
    */
   void handleUserInput(UserAction_t action, bool hold);
 
+  /**
+   * @brief Handles a key release; releasing Action ends a held boost.
+   * @param action The released action.
+   */
+  void handleUserRelease(UserAction_t action);
+
+  /**
+   * @brief Sets how a held Action boost repeats.
+   * @param delay_ms Hold before the first repeat (default
+   * kDefaultBoostDelayMs).
+   * @param repeat_ms Interval between repeats (default kDefaultBoostRepeatMs),
+   * at least 1 ms.
+   */
+  void setAutoRepeat(int delay_ms, int repeat_ms);
+
   /**
    * @brief Retrieves the current state of the game.
+   *
+   * Compatibility path: the returned field/next arrays are heap copies that
+   * the caller must delete[]. Prefer borrowState()/releaseState().
    * @return GameInfo_t The current game state information.
    */
   GameInfo_t getCurrentState();
 
+  /**
+   * @brief Updates the game and renders it into an engine-owned frame.
+   * @return Frame valid until releaseState(), or nullptr if both frames are
+   * still held by the caller.
+   */
+  const GameFrame_t* borrowState();
+
+  /**
+   * @brief Advances the game by a span of time.
+   *
+   * The snake moves once per speed interval of running time, no matter how
+   * the time is sliced, plus every boost repeat that falls due while Action
+   * is held; paused and finished games do not advance.
+   * @param seconds Time elapsed since the previous step, capped at one
+   * second.
+   */
+  void step(double seconds);
+
+  /**
+   * @brief Renders the game into an engine-owned frame without changing it.
+   * @return Frame valid until releaseState(), or nullptr if both frames are
+   * still held by the caller.
+   */
+  const GameFrame_t* snapshot();
+
+  /**
+   * @brief Returns a frame obtained from borrowState() or snapshot() to the
+   * engine.
+   * @param frame The frame to release.
+   */
+  void releaseState(const GameFrame_t* frame);
+
   /**
    * @brief Resets the game to its initial state.
    */
   void resetGame();
 
- private:
   /**
-   * @brief Private constructor for singleton pattern.
+   * @brief Reseeds the food generator and resets the game, so the following
+   * input stream replays deterministically.
+   * @param seed Seed of the food placement generator.
    */
-  Game();
+  void seed(std::uint64_t seed);
 
   /**
-   * @brief Destructor for cleanup.
+   * @brief Swaps the high score storage and loads the high score from it.
+   *
+   * Lets code that only reaches the default engine, such as a GameRunner,
+   * keep its high score out of the file.
+   * @param high_score_sink Where the high score is loaded from and saved to.
    */
-  ~Game();
+  void setHighScoreSink(std::unique_ptr<HighScoreSink> high_score_sink);
 
+ private:
   // Game state
   GameState current_state_;  ///< Current finite state machine state.
 
   // Game data
-  int** game_field_;         ///< 2D array representing the game field.
-  int** next_field_;         ///< 2D array for next state calculations.
-  std::deque<Point> snake_;  ///< Snake body segments (head at front).
+  static constexpr int kCellCount = FIELD_WIDTH * FIELD_HEIGHT;
+
+  /// Compact row-major cell index used for the snake body.
+  using Cell = std::uint8_t;
+  static_assert(kCellCount <= 256, "Cell index must fit the field");
+
+  std::unique_ptr<HighScoreSink> high_score_sink_;  ///< High score storage.
+  GameRandom_t rng_;  ///< Per-instance generator for food placement.
+
+  int game_field_[FIELD_HEIGHT][FIELD_WIDTH];  ///< The game field grid.
+  int next_field_[NEXT_FIELD_HEIGHT]
+                 [NEXT_FIELD_WIDTH];  ///< Next piece area (unused by Snake).
+  RingBuffer<Cell, kCellCount> snake_;  ///< Body segments (head at front).
   Point food_position_;      ///< Current food position.
   int score_;                ///< Current score.
   int high_score_;           ///< Highest score achieved (persistent).
   int level_;                ///< Current game level.
   int speed_;  ///< Update interval in milliseconds (lower = faster).
+  double move_time_;  ///< Seconds of step() time not yet spent on a move.
   // int tick_counter_; // Not strictly needed if QTimer directly uses speed_
 
   Point snake_direction_;  ///< Current movement direction of the snake.
 
+  // Held Action key: the press boosts at once, step() replays the repeats
+  bool boost_held_;           ///< Action pressed and not released yet.
+  double boost_held_for_;     ///< Seconds of running time since the press.
+  double boost_next_repeat_;  ///< boost_held_for_ at which a repeat is due.
+  int boost_delay_ms_;        ///< Hold before the first repeat.
+  int boost_repeat_ms_;       ///< Interval between repeats.
+
+  // Free-cell index: free_cells_[0, free_count_) lists every cell the snake
+  // does not cover, free_slot_ maps a cell back to its position there.
+  std::array<Cell, kCellCount> free_cells_;  ///< Cells not covered by snake.
+  std::array<Cell, kCellCount> free_slot_;   ///< Cell -> index in free_cells_.
+  int free_count_;                           ///< Number of free cells.
+
+  // Occupancy bitboard, one bit per cell (row-major), set where the snake
+  // body lies. game_field_ is kept in sync with it on every move.
+  std::bitset<kCellCount> occupied_;  ///< Cells covered by the snake.
+
+  GameFrameBuffer_t frame_buffer_;  ///< Double buffer behind borrowState().
+
   // Private helper functions for game logic
 
   /**
@@ -129,11 +341,52 @@ class Game {
    */
   void generateFood();
 
+  /**
+   * @brief Converts a field position to its row-major cell index.
+   * @param point The position on the field.
+   * @return The cell index.
+   */
+  static Cell cellIndex(const Point& point) {
+    return static_cast<Cell>(point.y * FIELD_WIDTH + point.x);
+  }
+
+  /**
+   * @brief Converts a row-major cell index back to its field position.
+   * @param cell The cell index.
+   * @return The position on the field.
+   */
+  static Point cellPoint(Cell cell) {
+    return {cell % FIELD_WIDTH, cell / FIELD_WIDTH};
+  }
+
+  /**
+   * @brief Marks every cell of the field as free.
+   */
+  void resetFreeCells();
+
+  /**
+   * @brief Removes a cell from the free-cell index (snake moved onto it).
+   * @param cell The cell that became occupied.
+   */
+  void occupyCell(Cell cell);
+
+  /**
+   * @brief Returns a cell to the free-cell index (snake left it).
+   * @param cell The cell that became free.
+   */
+  void vacateCell(Cell cell);
+
   /**
    * @brief Moves the snake in the current direction.
    */
   void moveSnake();
 
+  /**
+   * @brief Boosts once for every repeat of a held Action that fell due.
+   * @param seconds Running time elapsed since the previous step.
+   */
+  void repeatBoost(double seconds);
+
   /**
    * @brief Increases the snake's speed (decreases update interval).
    */
@@ -155,11 +408,15 @@ class Game {
   void updateGameLogic();
 
   /**
-   * @brief File path for storing the high score.
+   * @brief Copies the current game state into a frame.
+   * @param frame The frame to fill.
    */
-  const std::string kHighScoreFilePath = "high_score.txt";
+  void renderFrame(GameFrame_t* frame) const;
 };
 
+/// Former name of SnakeEngine, kept for existing callers.
+using Game = SnakeEngine;
+
 }  // namespace s21
 
 #endif  // S21_BRICK_GAME_SNAKE_GAME_H
\ No newline at end of file
@@ -1,108 +1,149 @@
+#define _POSIX_C_SOURCE 200809L // For clock_gettime()
+
 #include "tetris.h"
-#include <stdlib.h> // For malloc, free, rand, srand
+#include "tetris_bot.h"
+#include <stdint.h> // For uintptr_t
+#include <stdlib.h> // For malloc, free
 #include <string.h> // For memset, memcpy
-#include <time.h>   // For srand seeding
+#include <time.h>   // For the default seed and the monotonic clock
 
 // --- Game Constants and Definitions ---
 
-// Tetromino shapes (7 types, 4 rotations each)
-// Each piece is defined in a 4x4 grid. 1 means block, 0 means empty.
+// Tetromino geometry (7 types, 4 rotations each)
+// Each rotation is listed once as the (column, row) of its four blocks inside
+// a 4x4 grid, in row-major order. Every table below is expanded from this list
+// by the preprocessor, so nothing is computed or scanned at run time.
+// Rotations are the SRS spawn, right, reverse and left states, in that order.
 // Order: I, J, L, O, S, T, Z
+#define TETROMINO_TABLE(X) \
+    /* I */ X((0,1, 1,1, 2,1, 3,1), (2,0, 2,1, 2,2, 2,3), (0,2, 1,2, 2,2, 3,2), (1,0, 1,1, 1,2, 1,3)) \
+    /* J */ X((0,0, 0,1, 1,1, 2,1), (1,0, 2,0, 1,1, 1,2), (0,1, 1,1, 2,1, 2,2), (1,0, 1,1, 0,2, 1,2)) \
+    /* L */ X((2,0, 0,1, 1,1, 2,1), (1,0, 1,1, 1,2, 2,2), (0,1, 1,1, 2,1, 0,2), (0,0, 1,0, 1,1, 1,2)) \
+    /* O */ X((1,0, 2,0, 1,1, 2,1), (1,0, 2,0, 1,1, 2,1), (1,0, 2,0, 1,1, 2,1), (1,0, 2,0, 1,1, 2,1)) \
+    /* S */ X((1,0, 2,0, 0,1, 1,1), (1,0, 1,1, 2,1, 2,2), (1,1, 2,1, 0,2, 1,2), (0,0, 0,1, 1,1, 1,2)) \
+    /* T */ X((1,0, 0,1, 1,1, 2,1), (1,0, 1,1, 2,1, 1,2), (0,1, 1,1, 2,1, 1,2), (1,0, 0,1, 1,1, 1,2)) \
+    /* Z */ X((0,0, 1,0, 1,1, 2,1), (2,0, 1,1, 2,1, 1,2), (0,1, 1,1, 1,2, 2,2), (1,0, 0,1, 1,1, 0,2))
+
+// Per-rotation helpers; the cell list arrives as x0,y0, x1,y1, x2,y2, x3,y3
+#define MIN4(a, b, c, d) ((a) < (b) ? ((a) < (c) ? ((a) < (d) ? (a) : (d)) : ((c) < (d) ? (c) : (d))) \
+                                    : ((b) < (c) ? ((b) < (d) ? (b) : (d)) : ((c) < (d) ? (c) : (d))))
+#define MAX4(a, b, c, d) (-MIN4(-(a), -(b), -(c), -(d)))
+#define CELL_AT(c, r, x0, y0, x1, y1, x2, y2, x3, y3) \
+    (((x0) == (c) && (y0) == (r)) || ((x1) == (c) && (y1) == (r)) || \
+     ((x2) == (c) && (y2) == (r)) || ((x3) == (c) && (y3) == (r)))
+#define ROW_MASK(r, x0, y0, x1, y1, x2, y2, x3, y3) \
+    ((uint16_t)((((y0) == (r)) << (x0)) | (((y1) == (r)) << (x1)) | \
+                (((y2) == (r)) << (x2)) | (((y3) == (r)) << (x3))))
+#define COLUMN_BOTTOM(c, x0, y0, x1, y1, x2, y2, x3, y3) \
+    MAX4((x0) == (c) ? (y0) : -1, (x1) == (c) ? (y1) : -1, (x2) == (c) ? (y2) : -1, (x3) == (c) ? (y3) : -1)
+
+#define TETROMINO_LAYOUT(x0, y0, x1, y1, x2, y2, x3, y3) \
+    {.cells = {{x0, y0}, {x1, y1}, {x2, y2}, {x3, y3}}, \
+     .row_masks = {ROW_MASK(0, x0, y0, x1, y1, x2, y2, x3, y3), ROW_MASK(1, x0, y0, x1, y1, x2, y2, x3, y3), \
+                   ROW_MASK(2, x0, y0, x1, y1, x2, y2, x3, y3), ROW_MASK(3, x0, y0, x1, y1, x2, y2, x3, y3)}, \
+     .min_x = MIN4(x0, x1, x2, x3), .max_x = MAX4(x0, x1, x2, x3), \
+     .min_y = MIN4(y0, y1, y2, y3), .max_y = MAX4(y0, y1, y2, y3), \
+     .column_bottom = {COLUMN_BOTTOM(0, x0, y0, x1, y1, x2, y2, x3, y3), COLUMN_BOTTOM(1, x0, y0, x1, y1, x2, y2, x3, y3), \
+                       COLUMN_BOTTOM(2, x0, y0, x1, y1, x2, y2, x3, y3), COLUMN_BOTTOM(3, x0, y0, x1, y1, x2, y2, x3, y3)}},
+#define SHAPE_ROW(r, ...) {CELL_AT(0, r, __VA_ARGS__), CELL_AT(1, r, __VA_ARGS__), \
+                           CELL_AT(2, r, __VA_ARGS__), CELL_AT(3, r, __VA_ARGS__)}
+#define TETROMINO_SHAPE(...) \
+    {{SHAPE_ROW(0, __VA_ARGS__), SHAPE_ROW(1, __VA_ARGS__), SHAPE_ROW(2, __VA_ARGS__), SHAPE_ROW(3, __VA_ARGS__)}},
+// Every block lies inside the 4x4 grid and no two blocks share a cell
+#define CELL_IN_GRID(x, y) ((x) >= 0 && (x) < TETROMINO_GRID_SIZE && (y) >= 0 && (y) < TETROMINO_GRID_SIZE)
+#define SAME_CELL(xa, ya, xb, yb) ((xa) == (xb) && (ya) == (yb))
+#define TETROMINO_CHECK(x0, y0, x1, y1, x2, y2, x3, y3) \
+    _Static_assert(CELL_IN_GRID(x0, y0) && CELL_IN_GRID(x1, y1) && CELL_IN_GRID(x2, y2) && CELL_IN_GRID(x3, y3), \
+                   "tetromino block outside its 4x4 grid"); \
+    _Static_assert(!SAME_CELL(x0, y0, x1, y1) && !SAME_CELL(x0, y0, x2, y2) && !SAME_CELL(x0, y0, x3, y3) && \
+                   !SAME_CELL(x1, y1, x2, y2) && !SAME_CELL(x1, y1, x3, y3) && !SAME_CELL(x2, y2, x3, y3), \
+                   "tetromino blocks overlap");
+
+#define LAYOUT_ENTRY(r0, r1, r2, r3) \
+    {TETROMINO_LAYOUT r0 TETROMINO_LAYOUT r1 TETROMINO_LAYOUT r2 TETROMINO_LAYOUT r3},
+#define SHAPE_ENTRY(r0, r1, r2, r3) \
+    {TETROMINO_SHAPE r0 TETROMINO_SHAPE r1 TETROMINO_SHAPE r2 TETROMINO_SHAPE r3},
+#define CHECK_ENTRY(r0, r1, r2, r3) TETROMINO_CHECK r0 TETROMINO_CHECK r1 TETROMINO_CHECK r2 TETROMINO_CHECK r3
+
+TETROMINO_TABLE(CHECK_ENTRY)
+
+const TetrominoLayout tetromino_layouts[NUM_TETROMINO_TYPES][NUM_TETROMINO_ROTATIONS] = {
+    TETROMINO_TABLE(LAYOUT_ENTRY)
+};
+
+// The same pieces as 1/0 grids, for code that wants the plain 4x4 picture
 const TetrominoShape tetrominoes[NUM_TETROMINO_TYPES][NUM_TETROMINO_ROTATIONS] = {
-    // I piece
-    {{{{0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 0 (Horizontal)
-     {{{0,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,0,0}}}, // Rotation 1 (Vertical)
-     {{{0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 2
-     {{{0,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,0,0}}}},// Rotation 3
-    // J piece
-    {{{{1,0,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 0
-     {{{0,1,1,0}, {0,1,0,0}, {0,1,0,0}, {0,0,0,0}}}, // Rotation 1
-     {{{0,0,0,0}, {1,1,1,0}, {0,0,1,0}, {0,0,0,0}}}, // Rotation 2
-     {{{0,1,0,0}, {0,1,0,0}, {1,1,0,0}, {0,0,0,0}}}},// Rotation 3
-    // L piece
-    {{{{0,0,1,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 0
-     {{{0,1,0,0}, {0,1,0,0}, {0,1,1,0}, {0,0,0,0}}}, // Rotation 1
-     {{{0,0,0,0}, {1,1,1,0}, {1,0,0,0}, {0,0,0,0}}}, // Rotation 2
-     {{{1,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,0,0,0}}}},// Rotation 3
-    // O piece (same for all rotations)
-    {{{{0,1,1,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 0
-     {{{0,1,1,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 1
-     {{{0,1,1,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 2
-     {{{0,1,1,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}}}},// Rotation 3
-    // S piece
-    {{{{0,1,1,0}, {1,1,0,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 0
-     {{{0,1,0,0}, {0,1,1,0}, {0,0,1,0}, {0,0,0,0}}}, // Rotation 1
-     {{{0,1,1,0}, {1,1,0,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 2
-     {{{0,1,0,0}, {0,1,1,0}, {0,0,1,0}, {0,0,0,0}}}},// Rotation 3
-    // T piece
-    {{{{0,1,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 0
-     {{{0,1,0,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}}}, // Rotation 1
-     {{{0,0,0,0}, {1,1,1,0}, {0,1,0,0}, {0,0,0,0}}}, // Rotation 2
-     {{{0,1,0,0}, {1,1,0,0}, {0,1,0,0}, {0,0,0,0}}}},// Rotation 3
-    // Z piece
-    {{{{1,1,0,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 0
-     {{{0,0,1,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}}}, // Rotation 1
-     {{{1,1,0,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}}}, // Rotation 2
-     {{{0,0,1,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}}}},// Rotation 3
+    TETROMINO_TABLE(SHAPE_ENTRY)
 };
 
-// --- Static Global Game State Variables ---
-static int game_board[TETRIS_BOARD_HEIGHT][TETRIS_BOARD_WIDTH];
-static CurrentPieceState current_piece;
-static int next_piece_type;
-static int score;
-static int high_score;
-static int level;
-static int game_speed_ms; // Lower is faster
-static bool paused;
-static TetrisFSMState_t current_fsm_state;
-static GameState overall_game_state; // For GameInfo_t
-
-static unsigned long long game_timer_ticks; // Simple timer for piece falling speed
+// --- Game Tuning Constants ---
 static const int INITIAL_SPEED_MS = 500;
 static const int MAX_LEVEL = 10;
+// Longest span one tetris_update() or tetris_advance() simulates, so a
+// stalled frontend does not
+// come back to a piece that fell half the board; above the slowest gravity
+// period so polling at the gravity rate still drops a row per poll
+static const uint64_t MAX_UPDATE_NS = 1000000000u;
+// Absorbs rounding when frame times add up to exactly a delay or a row
+static const double TIME_EPSILON = 1e-9;
 static const int POINTS_PER_LEVEL_UP = 600;
-static int lines_cleared_for_level_up = 0;
+
+// Default context behind the global userInput()/updateCurrentState() API
+static TetrisContext default_context;
+static bool is_initialized = false;
 
 
 // --- Forward Declarations for Static Helper Functions ---
-static void reset_game_state();
-static void spawn_new_piece();
-static bool is_valid_position(int piece_x, int piece_y, int type, int rotation);
-static void lock_current_piece();
-static int clear_completed_lines();
-static void update_score_and_level(int lines_cleared_count);
-static void load_high_score_from_file();
-static void save_high_score_to_file();
-static void calculate_speed_from_level();
+static void reset_game_state(TetrisContext *ctx);
+static void spawn_new_piece(TetrisContext *ctx);
+static bool is_valid_position(const TetrisContext *ctx, int piece_x, int piece_y, int type, int rotation);
+static void lock_current_piece(TetrisContext *ctx);
+static void settle_piece(TetrisContext *ctx);
+static void refresh_metrics(TetrisBoard *board, int first_col, int last_col);
+static void update_score_and_level(TetrisContext *ctx, int lines_cleared_count);
+static void load_high_score_from_file(TetrisContext *ctx);
+static void save_high_score_to_file(const TetrisContext *ctx);
+static void calculate_speed_from_level(TetrisContext *ctx);
+static TetrisContext *default_tetris_context();
 static int **allocate_game_info_field();
 static int **allocate_game_info_next_piece_area();
-static void copy_board_to_game_info_field(int **dest_field);
-static void copy_next_piece_to_game_info_next(int **dest_next);
+static void composite_field(const TetrisContext *ctx, int **dest_field);
+static void stamp_piece(int **dest_field, int piece_x, int piece_y, int type, int rotation, int cell);
+static void copy_next_piece_to_game_info_next(const TetrisContext *ctx, int **dest_next);
+static void advance_game_state(TetrisContext *ctx);
+static void render_frame(const TetrisContext *ctx, GameFrame_t *frame);
 
 // --- Initialization ---
 void initialize_tetris_game() {
-    srand((unsigned int)time(NULL));
-    load_high_score_from_file();
-    reset_game_state();
-    next_piece_type = rand() % NUM_TETROMINO_TYPES;
-    current_fsm_state = TETRIS_STATE_START_SCREEN;
-    overall_game_state = START_SCREEN; // From GameCommon.h
+    if (is_initialized) {
+        tetris_reset(&default_context);
+    } else {
+        tetris_init(&default_context, HIGH_SCORE_FILENAME);
+    }
+    is_initialized = true;
 }
 
-static void reset_game_state() {
-    for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
-        for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
-            game_board[r][c] = EMPTY; // From GameCommon.h CellState
-        }
+// Lazily initialized context used by the global API
+static TetrisContext *default_tetris_context() {
+    if (!is_initialized) {
+        initialize_tetris_game();
     }
-    current_piece.active = false;
-    score = 0;
-    level = 1;
-    lines_cleared_for_level_up = 0;
-    calculate_speed_from_level();
-    paused = false;
-    game_timer_ticks = 0;
+    return &default_context;
+}
+
+static void reset_game_state(TetrisContext *ctx) {
+    tetris_board_reset(&ctx->board);
+    ctx->current_piece.active = false;
+    ctx->last_clear.count = 0;
+    ctx->score = 0;
+    ctx->level = 1;
+    ctx->lines_cleared_for_level_up = 0;
+    calculate_speed_from_level(ctx);
+    ctx->paused = false;
+    ctx->gravity_rows = 0.0;
+    ctx->entry_delay_left = 0.0;
+    ctx->shift.held = false; // Keys held into a restart must not repeat in the new game
+    ctx->soft_drop.held = false;
 
     // Select first piece and next piece
     // current_piece.type = rand() % NUM_TETROMINO_TYPES;
@@ -113,157 +154,336 @@ static void reset_game_state() {
 
 
 // --- High Score Handling ---
-static void load_high_score_from_file() {
-    FILE *fp = fopen(HIGH_SCORE_FILENAME, "r");
+static void load_high_score_from_file(TetrisContext *ctx) {
+    if (!ctx->high_score_path) return; // In-memory context keeps its high score
+    FILE *fp = fopen(ctx->high_score_path, "r");
     if (fp) {
-        if (fscanf(fp, "%d", &high_score) != 1) {
-            high_score = 0;
+        if (fscanf(fp, "%d", &ctx->high_score) != 1) {
+            ctx->high_score = 0;
         }
         fclose(fp);
     } else {
-        high_score = 0;
+        ctx->high_score = 0;
     }
 }
 
-static void save_high_score_to_file() {
-    FILE *fp = fopen(HIGH_SCORE_FILENAME, "w");
+static void save_high_score_to_file(const TetrisContext *ctx) {
+    if (!ctx->high_score_path) return;
+    FILE *fp = fopen(ctx->high_score_path, "w");
     if (fp) {
-        fprintf(fp, "%d", high_score);
+        fprintf(fp, "%d", ctx->high_score);
         fclose(fp);
     }
 }
 
 // --- Game Mechanics Helpers ---
-static void calculate_speed_from_level() {
-    if (level > MAX_LEVEL) level = MAX_LEVEL;
-    if (level < 1) level = 1;
+static void calculate_speed_from_level(TetrisContext *ctx) {
+    if (ctx->level > MAX_LEVEL) ctx->level = MAX_LEVEL;
+    if (ctx->level < 1) ctx->level = 1;
     // Example speed calculation: Starts at INITIAL_SPEED_MS, decreases by 40ms per level
-    game_speed_ms = INITIAL_SPEED_MS - (level - 1) * 40;
-    if (game_speed_ms < 50) game_speed_ms = 50; // Minimum speed
+    ctx->game_speed_ms = INITIAL_SPEED_MS - (ctx->level - 1) * 40;
+    if (ctx->game_speed_ms < 50) ctx->game_speed_ms = 50; // Minimum speed
+    ctx->gravity = 1000.0 / ctx->game_speed_ms;
 }
 
-static void spawn_new_piece() {
-    current_piece.type = next_piece_type;
-    next_piece_type = rand() % NUM_TETROMINO_TYPES;
+// Draws the next piece of the bag, shuffling a fresh bag (Fisher-Yates) when
+// the current one is used up
+static int draw_from_bag(TetrisContext *ctx) {
+    TetrisPieceQueue *q = &ctx->queue;
+    if (q->bag_left == 0) {
+        for (int i = 0; i < NUM_TETROMINO_TYPES; ++i) q->bag[i] = (int8_t)i;
+        for (int i = NUM_TETROMINO_TYPES - 1; i > 0; --i) {
+            int j = (int)boundedGameRandom(&ctx->rng, (uint32_t)i + 1);
+            int8_t t = q->bag[i];
+            q->bag[i] = q->bag[j];
+            q->bag[j] = t;
+        }
+        q->bag_left = NUM_TETROMINO_TYPES;
+    }
+    return q->bag[--q->bag_left];
+}
+
+// Starts a new piece sequence and fills the preview ring from it
+static void fill_piece_queue(TetrisContext *ctx) {
+    ctx->queue.bag_left = 0;
+    ctx->queue.head = 0;
+    for (int i = 0; i < TETRIS_PREVIEW_LENGTH; ++i) {
+        ctx->queue.ring[i] = (int8_t)draw_from_bag(ctx);
+    }
+}
+
+// Takes the piece at the head of the ring and refills its slot
+static int pop_piece_queue(TetrisContext *ctx) {
+    TetrisPieceQueue *q = &ctx->queue;
+    int type = q->ring[q->head];
+    q->ring[q->head] = (int8_t)draw_from_bag(ctx);
+    q->head = (q->head + 1) % TETRIS_PREVIEW_LENGTH;
+    return type;
+}
 
-    current_piece.rotation = 0;
-    current_piece.x = TETRIS_BOARD_WIDTH / 2 - TETROMINO_GRID_SIZE / 2; // Centered
-    current_piece.y = 0; // Start at the top
+static void spawn_new_piece(TetrisContext *ctx) {
+    ctx->current_piece.type = pop_piece_queue(ctx);
 
-    current_piece.active = true;
+    ctx->current_piece.rotation = 0;
+    ctx->current_piece.x = TETRIS_SPAWN_X; // Centered
+    ctx->current_piece.y = TETRIS_SPAWN_Y; // Start at the top
 
-    if (!is_valid_position(current_piece.x, current_piece.y, current_piece.type, current_piece.rotation)) {
-        current_fsm_state = TETRIS_STATE_GAME_OVER;
-        overall_game_state = GAME_OVER_LOSE;
-        current_piece.active = false;
-        if (score > high_score) {
-            high_score = score;
-            save_high_score_to_file();
+    ctx->current_piece.active = true;
+    ctx->pieces_spawned++;
+
+    if (!is_valid_position(ctx, ctx->current_piece.x, ctx->current_piece.y, ctx->current_piece.type, ctx->current_piece.rotation)) {
+        ctx->current_fsm_state = TETRIS_STATE_GAME_OVER;
+        ctx->overall_game_state = GAME_OVER_LOSE;
+        ctx->current_piece.active = false;
+        if (ctx->score > ctx->high_score) {
+            ctx->high_score = ctx->score;
+            save_high_score_to_file(ctx);
         }
     } else {
-        current_fsm_state = TETRIS_STATE_MOVING;
-        overall_game_state = GAME_RUNNING;
+        ctx->current_fsm_state = TETRIS_STATE_MOVING;
+        ctx->overall_game_state = GAME_RUNNING;
     }
-    game_timer_ticks = 0; // Reset fall timer
+    ctx->gravity_rows = 0.0; // A new piece waits a full gravity period
 }
 
-static bool is_valid_position(int piece_x, int piece_y, int type, int rotation) {
-    const TetrominoShape* s = &tetrominoes[type][rotation];
-    for (int r_offset = 0; r_offset < TETROMINO_GRID_SIZE; ++r_offset) {
-        for (int c_offset = 0; c_offset < TETROMINO_GRID_SIZE; ++c_offset) {
-            if (s->shape[r_offset][c_offset] == 1) { // If part of the piece
-                int board_r = piece_y + r_offset;
-                int board_c = piece_x + c_offset;
+static bool is_valid_position(const TetrisContext *ctx, int piece_x, int piece_y, int type, int rotation) {
+    return tetris_board_fits(&ctx->board, piece_x, piece_y, type, rotation);
+}
 
-                // Check boundaries
-                if (board_c < 0 || board_c >= TETRIS_BOARD_WIDTH || board_r < 0 || board_r >= TETRIS_BOARD_HEIGHT) {
-                    return false; // Out of bounds
-                }
-                // Check collision with existing blocks on the board
-                if (game_board[board_r][board_c] != EMPTY) {
-                    return false; // Collision with another block
-                }
-            }
+// --- Board ---
+
+void tetris_board_reset(TetrisBoard *board) {
+    for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
+        board->rows[r] = TETRIS_ROW_EMPTY; // Only the wall bits set
+    }
+    for (int r = TETRIS_BOARD_HEIGHT; r < TETRIS_BOARD_HEIGHT + TETRIS_FLOOR_ROWS; ++r) {
+        board->rows[r] = TETRIS_ROW_FULL;
+    }
+    memset(board->column_masks, 0, sizeof(board->column_masks));
+    memset(&board->metrics, 0, sizeof(board->metrics)); // An empty board has no heights, holes or wells
+}
+
+bool tetris_board_fits(const TetrisBoard *board, int piece_x, int piece_y, int type, int rotation) {
+    int shift = piece_x + TETRIS_WALL_BITS;
+    if (shift < 0) return false; // Further left than the wall bits reach
+    const TetrominoLayout *layout = &tetromino_layouts[type][rotation];
+    if (piece_y + layout->min_y < 0) return false; // Above the top of the board
+    if (piece_y + layout->max_y >= TETRIS_BOARD_HEIGHT + TETRIS_FLOOR_ROWS) return false; // Below the floor rows
+    for (int r_offset = layout->min_y; r_offset <= layout->max_y; ++r_offset) {
+        // Bits shifted past the 16-bit row hit the (implicit) right wall
+        uint32_t board_row = board->rows[piece_y + r_offset] | ~(uint32_t)TETRIS_ROW_FULL;
+        if (((uint32_t)layout->row_masks[r_offset] << shift) & board_row) {
+            return false; // Collision with a wall, the floor or another block
         }
     }
     return true;
 }
 
-static void lock_current_piece() {
-    if (!current_piece.active) return;
+static int column_height(uint32_t mask) {
+    return mask ? TETRIS_BOARD_HEIGHT - __builtin_ctz(mask) : 0; // Lowest bit is the top block
+}
 
-    const TetrominoShape* s = &tetrominoes[current_piece.type][current_piece.rotation];
-    for (int r_offset = 0; r_offset < TETROMINO_GRID_SIZE; ++r_offset) {
-        for (int c_offset = 0; c_offset < TETROMINO_GRID_SIZE; ++c_offset) {
-            if (s->shape[r_offset][c_offset] == 1) {
-                int board_r = current_piece.y + r_offset;
-                int board_c = current_piece.x + c_offset;
-                // Ensure it's within bounds before locking, though is_valid_position should handle this
-                if (board_r >= 0 && board_r < TETRIS_BOARD_HEIGHT && board_c >= 0 && board_c < TETRIS_BOARD_WIDTH) {
-                     game_board[board_r][board_c] = BODY; // Use BODY from CellState
-                }
-            }
+static int well_depth(const TetrisBoardMetrics *m, int c) {
+    int left = c > 0 ? m->heights[c - 1] : TETRIS_BOARD_HEIGHT;
+    int right = c < TETRIS_BOARD_WIDTH - 1 ? m->heights[c + 1] : TETRIS_BOARD_HEIGHT;
+    int depth = (left < right ? left : right) - m->heights[c];
+    return depth > 0 ? depth : 0;
+}
+
+// Recomputes the metrics of columns first_col..last_col from their masks and
+// patches the aggregates, bumpiness terms and wells those columns affect.
+static void refresh_metrics(TetrisBoard *board, int first_col, int last_col) {
+    TetrisBoardMetrics *m = &board->metrics;
+    int first_pair = first_col > 0 ? first_col - 1 : 0;
+    int last_pair = last_col < TETRIS_BOARD_WIDTH - 1 ? last_col : TETRIS_BOARD_WIDTH - 2;
+    for (int c = first_pair; c <= last_pair; ++c) {
+        m->bumpiness -= abs(m->heights[c] - m->heights[c + 1]);
+    }
+    for (int c = first_col; c <= last_col; ++c) {
+        uint32_t mask = board->column_masks[c];
+        int height = column_height(mask);
+        int holes = height - __builtin_popcount(mask);
+        m->aggregate_height += height - m->heights[c];
+        m->total_holes += holes - m->holes[c];
+        m->heights[c] = height;
+        m->holes[c] = holes;
+    }
+    for (int c = first_pair; c <= last_pair; ++c) {
+        m->bumpiness += abs(m->heights[c] - m->heights[c + 1]);
+    }
+    int first_well = first_col > 0 ? first_col - 1 : 0;
+    int last_well = last_col < TETRIS_BOARD_WIDTH - 1 ? last_col + 1 : TETRIS_BOARD_WIDTH - 1;
+    for (int c = first_well; c <= last_well; ++c) {
+        m->well_depths[c] = well_depth(m, c);
+    }
+}
+
+void tetris_board_place(TetrisBoard *board, int piece_x, int piece_y, int type, int rotation) {
+    const TetrominoLayout *layout = &tetromino_layouts[type][rotation];
+    int shift = piece_x + TETRIS_WALL_BITS;
+    for (int r_offset = layout->min_y; r_offset <= layout->max_y; ++r_offset) {
+        int board_r = piece_y + r_offset;
+        // Ensure it's within bounds before locking, though is_valid_position should handle this
+        if (board_r >= 0 && board_r < TETRIS_BOARD_HEIGHT && shift >= 0) {
+            board->rows[board_r] |= (uint16_t)((uint32_t)layout->row_masks[r_offset] << shift);
+        }
+    }
+    for (int i = 0; i < TETROMINO_CELL_COUNT; ++i) {
+        int board_r = piece_y + layout->cells[i][1];
+        int board_c = piece_x + layout->cells[i][0];
+        if (board_r >= 0 && board_r < TETRIS_BOARD_HEIGHT && board_c >= 0 && board_c < TETRIS_BOARD_WIDTH) {
+            board->column_masks[board_c] |= 1u << board_r;
         }
     }
-    current_piece.active = false;
-    current_fsm_state = TETRIS_STATE_LINE_CLEAR;
+    int first_col = piece_x + layout->min_x;
+    int last_col = piece_x + layout->max_x;
+    refresh_metrics(board, first_col > 0 ? first_col : 0,
+                    last_col < TETRIS_BOARD_WIDTH - 1 ? last_col : TETRIS_BOARD_WIDTH - 1);
 }
 
-static int clear_completed_lines() {
-    int lines_cleared_count = 0;
+// Removes every full row in one bottom-up pass: surviving rows are copied
+// straight to their final position and the freed rows at the top are emptied.
+TetrisLineClear tetris_board_clear_lines(TetrisBoard *board) {
+    TetrisLineClear clear = {0};
+    int write_r = TETRIS_BOARD_HEIGHT - 1;
     for (int r = TETRIS_BOARD_HEIGHT - 1; r >= 0; --r) {
-        bool line_complete = true;
-        for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
-            if (game_board[r][c] == EMPTY) {
-                line_complete = false;
-                break;
-            }
+        if (board->rows[r] == TETRIS_ROW_FULL) {
+            if (clear.count < TETROMINO_GRID_SIZE) clear.rows[clear.count] = r;
+            clear.count++;
+        } else {
+            board->rows[write_r--] = board->rows[r];
         }
-
-        if (line_complete) {
-            lines_cleared_count++;
-            // Move all lines above this one down
-            for (int move_r = r; move_r > 0; --move_r) {
-                for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
-                    game_board[move_r][c] = game_board[move_r - 1][c];
-                }
-            }
-            // Clear the top line
+    }
+    while (write_r >= 0) {
+        board->rows[write_r--] = TETRIS_ROW_EMPTY;
+    }
+    if (clear.count > 0) {
+        // Drop each cleared bit from the column masks, top-most row first so
+        // the indices of the rows still to remove stay valid
+        int recorded = clear.count < TETROMINO_GRID_SIZE ? clear.count : TETROMINO_GRID_SIZE;
+        for (int i = recorded - 1; i >= 0; --i) {
+            uint32_t above = (1u << clear.rows[i]) - 1u;
             for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
-                game_board[0][c] = EMPTY;
+                uint32_t mask = board->column_masks[c];
+                board->column_masks[c] = (mask & ~above & ~(1u << clear.rows[i])) | ((mask & above) << 1);
             }
-            r++; // Re-check the current row index as it now contains the row from above
         }
+        refresh_metrics(board, 0, TETRIS_BOARD_WIDTH - 1);
     }
-    return lines_cleared_count;
+    return clear;
 }
 
-static void update_score_and_level(int lines_cleared_count) {
+// SRS wall kicks, indexed [from rotation][0 clockwise, 1 counter-clockwise].
+// Offsets are written as in the guideline, with y pointing up; K() turns them
+// into board (x, row) steps. O never needs a kick: its rotations coincide.
+#define KICK_TESTS 5
+#define K(x, y) {x, -(y)}
+static const int8_t jlstz_kicks[NUM_TETROMINO_ROTATIONS][2][KICK_TESTS][2] = {
+    {{K(0, 0), K(-1, 0), K(-1, 1), K(0, -2), K(-1, -2)},   // 0 -> R
+     {K(0, 0), K(1, 0), K(1, 1), K(0, -2), K(1, -2)}},     // 0 -> L
+    {{K(0, 0), K(1, 0), K(1, -1), K(0, 2), K(1, 2)},       // R -> 2
+     {K(0, 0), K(1, 0), K(1, -1), K(0, 2), K(1, 2)}},      // R -> 0
+    {{K(0, 0), K(1, 0), K(1, 1), K(0, -2), K(1, -2)},      // 2 -> L
+     {K(0, 0), K(-1, 0), K(-1, 1), K(0, -2), K(-1, -2)}},  // 2 -> R
+    {{K(0, 0), K(-1, 0), K(-1, -1), K(0, 2), K(-1, 2)},    // L -> 0
+     {K(0, 0), K(-1, 0), K(-1, -1), K(0, 2), K(-1, 2)}},   // L -> 2
+};
+static const int8_t i_kicks[NUM_TETROMINO_ROTATIONS][2][KICK_TESTS][2] = {
+    {{K(0, 0), K(-2, 0), K(1, 0), K(-2, -1), K(1, 2)},     // 0 -> R
+     {K(0, 0), K(-1, 0), K(2, 0), K(-1, 2), K(2, -1)}},    // 0 -> L
+    {{K(0, 0), K(-1, 0), K(2, 0), K(-1, 2), K(2, -1)},     // R -> 2
+     {K(0, 0), K(2, 0), K(-1, 0), K(2, 1), K(-1, -2)}},    // R -> 0
+    {{K(0, 0), K(2, 0), K(-1, 0), K(2, 1), K(-1, -2)},     // 2 -> L
+     {K(0, 0), K(1, 0), K(-2, 0), K(1, -2), K(-2, 1)}},    // 2 -> R
+    {{K(0, 0), K(1, 0), K(-2, 0), K(1, -2), K(-2, 1)},     // L -> 0
+     {K(0, 0), K(-2, 0), K(1, 0), K(-2, -1), K(1, 2)}},    // L -> 2
+};
+#undef K
+
+bool tetris_board_rotate(const TetrisBoard *board, int type, int *piece_x, int *piece_y, int *rotation,
+                         int direction) {
+    int from = *rotation;
+    int to = (from + (direction > 0 ? 1 : NUM_TETROMINO_ROTATIONS - 1)) % NUM_TETROMINO_ROTATIONS;
+    const int8_t (*kicks)[2] = (type == 0 /* I */ ? i_kicks : jlstz_kicks)[from][direction > 0 ? 0 : 1];
+    for (int i = 0; i < KICK_TESTS; ++i) {
+        int x = *piece_x + kicks[i][0];
+        int y = *piece_y + kicks[i][1];
+        if (tetris_board_fits(board, x, y, type, to)) {
+            *piece_x = x;
+            *piece_y = y;
+            *rotation = to;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Rows a piece can fall before it rests on the stack or the floor. Each
+// column of the piece is compared with the first locked block below its
+// lowest cell, so this costs one mask lookup per piece column.
+int tetris_board_drop_distance(const TetrisBoard *board, int piece_x, int piece_y, int type, int rotation) {
+    const TetrominoLayout *layout = &tetromino_layouts[type][rotation];
+    int distance = TETRIS_BOARD_HEIGHT;
+    for (int c = layout->min_x; c <= layout->max_x; ++c) {
+        int bottom = piece_y + layout->column_bottom[c];
+        uint32_t below = board->column_masks[piece_x + c];
+        if (bottom >= 0) below &= ~((2u << bottom) - 1u); // Only blocks under the piece
+        int surface = below ? __builtin_ctz(below) : TETRIS_BOARD_HEIGHT;
+        if (surface - bottom - 1 < distance) distance = surface - bottom - 1;
+    }
+    return distance;
+}
+
+// --- Game Mechanics ---
+
+static void lock_current_piece(TetrisContext *ctx) {
+    if (!ctx->current_piece.active) return;
+
+    const CurrentPieceState *p = &ctx->current_piece;
+    tetris_board_place(&ctx->board, p->x, p->y, p->type, p->rotation);
+    ctx->current_piece.active = false;
+}
+
+// Locks the landed piece, clears full lines and brings in the next piece,
+// all in the gravity tick or drop input that landed it. With an entry delay
+// the next piece waits in TETRIS_STATE_SPAWN until tetris_advance() has run the delay down.
+static void settle_piece(TetrisContext *ctx) {
+    lock_current_piece(ctx);
+    ctx->last_clear = tetris_board_clear_lines(&ctx->board);
+    if (ctx->last_clear.count > 0) {
+        update_score_and_level(ctx, ctx->last_clear.count);
+    }
+    ctx->current_fsm_state = TETRIS_STATE_SPAWN;
+    ctx->entry_delay_left = ctx->entry_delay_ms / 1000.0;
+    if (ctx->entry_delay_ms == 0) spawn_new_piece(ctx);
+}
+
+static void update_score_and_level(TetrisContext *ctx, int lines_cleared_count) {
     if (lines_cleared_count > 0) {
         switch (lines_cleared_count) {
-            case 1: score += 100; break;
-            case 2: score += 300; break;
-            case 3: score += 700; break;
-            case 4: score += 1500; break; // Tetris!
-            default: score += 1500 + (lines_cleared_count - 4) * 800; // Bonus for more than 4
+            case 1: ctx->score += 100; break;
+            case 2: ctx->score += 300; break;
+            case 3: ctx->score += 700; break;
+            case 4: ctx->score += 1500; break; // Tetris!
+            default: ctx->score += 1500 + (lines_cleared_count - 4) * 800; // Bonus for more than 4
         }
-        if (score > high_score) {
-            high_score = score; // Update high score in real-time, save on game over
+        if (ctx->score > ctx->high_score) {
+            ctx->high_score = ctx->score; // Update high score in real-time, save on game over
         }
 
-        lines_cleared_for_level_up += lines_cleared_count; // Using lines cleared, not points for level up
+        ctx->lines_cleared_for_level_up += lines_cleared_count; // Using lines cleared, not points for level up
                                                            // README: "Each time a player gains 600 points, the level increases by 1"
                                                            // Let's adjust to use points.
         // This logic should be based on score threshold as per README.
         // Example: if previous_score / 600 < current_score / 600, then level up.
         // More simply:
-        int old_level_threshold = (score - (lines_cleared_count == 1 ? 100 : (lines_cleared_count == 2 ? 300 : (lines_cleared_count == 3 ? 700 : (lines_cleared_count == 4 ? 1500 : 0))))) / POINTS_PER_LEVEL_UP;
-        int new_level_threshold = score / POINTS_PER_LEVEL_UP;
+        int old_level_threshold = (ctx->score - (lines_cleared_count == 1 ? 100 : (lines_cleared_count == 2 ? 300 : (lines_cleared_count == 3 ? 700 : (lines_cleared_count == 4 ? 1500 : 0))))) / POINTS_PER_LEVEL_UP;
+        int new_level_threshold = ctx->score / POINTS_PER_LEVEL_UP;
 
-        if (new_level_threshold > old_level_threshold && level < MAX_LEVEL) {
-             level = (new_level_threshold) + 1; // Level is 1-based
-             if(level > MAX_LEVEL) level = MAX_LEVEL;
-             calculate_speed_from_level();
+        if (new_level_threshold > old_level_threshold && ctx->level < MAX_LEVEL) {
+             ctx->level = (new_level_threshold) + 1; // Level is 1-based
+             if(ctx->level > MAX_LEVEL) ctx->level = MAX_LEVEL;
+             calculate_speed_from_level(ctx);
         }
     }
 }
@@ -299,99 +519,112 @@ static int **allocate_game_info_next_piece_area() {
     return next_area;
 }
 
-static void copy_board_to_game_info_field(int **dest_field) {
+// Writes the four blocks of a piece into a field, clipping at the board edges
+static void stamp_piece(int **dest_field, int piece_x, int piece_y, int type, int rotation, int cell) {
+    const TetrominoLayout *layout = &tetromino_layouts[type][rotation];
+    for (int i = 0; i < TETROMINO_CELL_COUNT; ++i) {
+        int board_r = piece_y + layout->cells[i][1];
+        int board_c = piece_x + layout->cells[i][0];
+        if (board_r >= 0 && board_r < TETRIS_BOARD_HEIGHT && board_c >= 0 && board_c < TETRIS_BOARD_WIDTH) {
+            dest_field[board_r][board_c] = cell;
+        }
+    }
+}
+
+// Rows the active piece can fall before it rests on the stack or the floor
+static int drop_distance(const TetrisContext *ctx) {
+    const CurrentPieceState *p = &ctx->current_piece;
+    return tetris_board_drop_distance(&ctx->board, p->x, p->y, p->type, p->rotation);
+}
+
+// Snapshot compositor: one pass over the board rows, then the ghost (if
+// enabled) and the falling piece are stamped on top, four cells each.
+static void composite_field(const TetrisContext *ctx, int **dest_field) {
     if (!dest_field) return;
     for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
+        unsigned bits = (unsigned)ctx->board.rows[r] >> TETRIS_WALL_BITS;
+        int *row = dest_field[r];
         for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
-            dest_field[r][c] = game_board[r][c];
-            // If a piece is active, draw it onto this temporary field
-            if (current_piece.active) {
-                const TetrominoShape* piece_shape = &tetrominoes[current_piece.type][current_piece.rotation];
-                for (int pr = 0; pr < TETROMINO_GRID_SIZE; ++pr) {
-                    for (int pc = 0; pc < TETROMINO_GRID_SIZE; ++pc) {
-                        if (piece_shape->shape[pr][pc] == 1) {
-                            int board_r = current_piece.y + pr;
-                            int board_c = current_piece.x + pc;
-                            if (board_r == r && board_c == c) {
-                                dest_field[r][c] = BODY; // Draw active piece as BODY
-                            }
-                        }
-                    }
-                }
-            }
+            row[c] = (bits >> c) & 1u ? BODY : EMPTY;
+        }
+    }
+    if (ctx->current_piece.active) {
+        const CurrentPieceState *p = &ctx->current_piece;
+        if (ctx->show_ghost) {
+            stamp_piece(dest_field, p->x, p->y + drop_distance(ctx), p->type, p->rotation, GHOST);
         }
+        stamp_piece(dest_field, p->x, p->y, p->type, p->rotation, BODY); // Draw active piece as BODY
     }
 }
 
-static void copy_next_piece_to_game_info_next(int **dest_next) {
+static void copy_next_piece_to_game_info_next(const TetrisContext *ctx, int **dest_next) {
     if (!dest_next) return;
-    const TetrominoShape* s = &tetrominoes[next_piece_type][0]; // Show default rotation
     for (int r = 0; r < TETROMINO_GRID_SIZE; ++r) {
-        if (!dest_next[r]) continue; // Prevent possible null pointer dereference
+        if (!dest_next[r]) return; // Prevent possible null pointer dereference
         for (int c = 0; c < TETROMINO_GRID_SIZE; ++c) {
-            if (s->shape[r][c] == 1) {
-                dest_next[r][c] = BODY;
-            } else {
-                dest_next[r][c] = EMPTY;
-            }
+            dest_next[r][c] = EMPTY;
         }
     }
+    const TetrominoLayout *layout = &tetromino_layouts[tetris_preview_piece(ctx, 0)][0]; // Show default rotation
+    for (int i = 0; i < TETROMINO_CELL_COUNT; ++i) {
+        dest_next[layout->cells[i][1]][layout->cells[i][0]] = BODY;
+    }
 }
 
-// --- API Functions ---
+// --- Context API ---
 
-// This is a very basic static instance, not ideal for multiple game instances
-// but typical for a simple C library for one game.
-static bool is_initialized = false;
+void tetris_init(TetrisContext *ctx, const char *high_score_path) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->high_score_path = high_score_path;
+    initGameFrameBuffer(&ctx->frame_buffer);
+    load_high_score_from_file(ctx);
+    tetris_set_auto_shift(ctx, TETRIS_DEFAULT_DAS_MS, TETRIS_DEFAULT_ARR_MS);
+    // Mix in the context address so contexts created in the same second differ
+    tetris_seed(ctx, (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)ctx);
+}
 
-void userInput(UserAction_t action, bool hold) {
-    if (!is_initialized) { // Lazy initialization
-        initialize_tetris_game();
-        is_initialized = true;
-    }
+void tetris_reset(TetrisContext *ctx) {
+    tetris_set_autopilot(ctx, false);
+    tetris_init(ctx, ctx->high_score_path);
+}
 
-    if (action == Terminate) {
-        current_fsm_state = TETRIS_STATE_GAME_OVER; // Or a specific terminate state
-        overall_game_state = TERMINATE_GAME;
-        if (score > high_score) { // Save score on terminate too
-             save_high_score_to_file();
-        }
-        return;
-    }
+void tetris_seed(TetrisContext *ctx, uint64_t seed) {
+    seedGameRandom(&ctx->rng, seed);
+    reset_game_state(ctx);
+    fill_piece_queue(ctx);
+    ctx->current_fsm_state = TETRIS_STATE_START_SCREEN;
+    ctx->overall_game_state = START_SCREEN; // From GameCommon.h
+}
 
-    if (action == Start) {
-        if (current_fsm_state == TETRIS_STATE_START_SCREEN || current_fsm_state == TETRIS_STATE_GAME_OVER || overall_game_state == PAUSED) {
-            reset_game_state(); // Resets board, score, level
-            // next_piece_type = rand() % NUM_TETROMINO_TYPES;
-            load_high_score_from_file(); // Ensure high score is fresh for new game
-            current_fsm_state = TETRIS_STATE_SPAWN;
-            overall_game_state = GAME_RUNNING;
-        }
-        return; // Start action consumes the input here
-    }
-    
-    // Actions below are only valid if game is running and not on start/gameover screen
-    if (current_fsm_state == TETRIS_STATE_START_SCREEN || current_fsm_state == TETRIS_STATE_GAME_OVER) {
-        return;
+TetrisContext *tetris_create(const char *high_score_path) {
+    TetrisContext *ctx = (TetrisContext *)calloc(1, sizeof(TetrisContext));
+    if (ctx) {
+        tetris_init(ctx, high_score_path);
     }
+    return ctx;
+}
 
-    if (action == Pause) {
-        paused = !paused;
-        if (paused) {
-            overall_game_state = PAUSED;
-        } else {
-            overall_game_state = GAME_RUNNING;
-            game_timer_ticks = 0; // Reset timer on unpause to avoid instant drop
-        }
-        return;
-    }
+void tetris_destroy(TetrisContext *ctx) {
+    if (ctx) tetris_bot_destroy(ctx->autopilot);
+    free(ctx);
+}
 
-    if (paused) return; // No game actions if paused
+void tetris_set_autopilot(TetrisContext *ctx, bool enabled) {
+    if (enabled && !ctx->autopilot) {
+        ctx->autopilot = tetris_bot_create(1); // One thread per game, however many games run
+        ctx->autopilot_plan.piece = 0;         // Plan the falling piece afresh
+    } else if (!enabled && ctx->autopilot) {
+        tetris_bot_destroy(ctx->autopilot);
+        ctx->autopilot = NULL;
+    }
+}
 
-    if (current_piece.active && current_fsm_state == TETRIS_STATE_MOVING) {
-        int new_x = current_piece.x;
-        int new_y = current_piece.y;
-        int new_rotation = current_piece.rotation;
+// Moves, rotates or drops the falling piece, if there is one
+static void apply_action(TetrisContext *ctx, UserAction_t action) {
+    if (ctx->current_piece.active && ctx->current_fsm_state == TETRIS_STATE_MOVING) {
+        int new_x = ctx->current_piece.x;
+        int new_y = ctx->current_piece.y;
+        int new_rotation = ctx->current_piece.rotation;
 
         switch (action) {
             case Left:
@@ -402,138 +635,382 @@ void userInput(UserAction_t action, bool hold) {
                 break;
             case Down: // Soft drop: move one step down
                 new_y++;
-                game_timer_ticks = 0; // Reset auto-fall timer, making it feel faster
+                ctx->gravity_rows = 0.0; // Restart the gravity period, making it feel faster
+                break;
+            case Up: // Hard drop: straight to the landing row, then lock
+                new_y += drop_distance(ctx);
                 break;
-            case Action: // Rotate
-                new_rotation = (current_piece.rotation + 1) % NUM_TETROMINO_ROTATIONS;
+            case Action:    // Rotate clockwise
+            case AltAction: // Rotate counter-clockwise
+                tetris_board_rotate(&ctx->board, ctx->current_piece.type, &new_x, &new_y, &new_rotation,
+                                    action == Action ? 1 : -1);
                 break;
             default:
-                break; // Other actions like Up are not handled here
+                break;
         }
 
-        if (is_valid_position(new_x, new_y, current_piece.type, new_rotation)) {
-            current_piece.x = new_x;
-            current_piece.y = new_y;
-            current_piece.rotation = new_rotation;
+        if (is_valid_position(ctx, new_x, new_y, ctx->current_piece.type, new_rotation)) {
+            ctx->current_piece.x = new_x;
+            ctx->current_piece.y = new_y;
+            ctx->current_piece.rotation = new_rotation;
+            if (action == Up) settle_piece(ctx);
         } else if (action == Down) {
             // If Down action made it invalid, it means it hit something, so lock it
-            current_fsm_state = TETRIS_STATE_LOCKING;
+            settle_piece(ctx);
         }
     }
 }
 
-GameInfo_t updateCurrentState() {
-    if (!is_initialized) {
-        initialize_tetris_game();
-        is_initialized = true;
+static TetrisHeldKey *held_key(TetrisContext *ctx, UserAction_t action) {
+    return action == Down ? &ctx->soft_drop : &ctx->shift;
+}
+
+static void press_key(TetrisContext *ctx, TetrisHeldKey *key, UserAction_t action) {
+    key->action = action;
+    key->held = true;
+    key->held_for = 0.0;
+    key->next_repeat = (action == Down ? ctx->arr_ms : ctx->das_ms) / 1000.0;
+}
+
+// Replays a held key for every repeat that fell due during `seconds`
+static void repeat_held_key(TetrisContext *ctx, TetrisHeldKey *key, double seconds) {
+    if (!key->held) return;
+    key->held_for += seconds;
+    double interval = ctx->arr_ms / 1000.0;
+    while (key->held_for >= key->next_repeat - TIME_EPSILON &&
+           ctx->current_fsm_state == TETRIS_STATE_MOVING) {
+        if (interval <= 0.0) { // Instant repeat: as far as the piece goes
+            CurrentPieceState before;
+            do {
+                before = ctx->current_piece;
+                apply_action(ctx, key->action);
+            } while (ctx->current_fsm_state == TETRIS_STATE_MOVING &&
+                     (ctx->current_piece.x != before.x || ctx->current_piece.y != before.y));
+            key->next_repeat = key->held_for;
+            return;
+        }
+        apply_action(ctx, key->action);
+        key->next_repeat += interval;
+    }
+    // A key held through a spawn keeps its charge but does not bank repeats
+    if (key->next_repeat < key->held_for) key->next_repeat = key->held_for;
+}
+
+// Wait before the autopilot plays action `index` of its plan: none for the
+// first, an auto-repeat interval between shifts and a gravity period before
+// the hard drop
+static double autopilot_delay(const TetrisContext *ctx, int index) {
+    if (index == ctx->autopilot_plan.action_count - 1) return 1.0 / ctx->gravity;
+    return index == 0 ? 0.0 : ctx->arr_ms / 1000.0;
+}
+
+// Lets the bot play the falling piece the way a player would: one search
+// when the piece appears, then its actions as they fall due over `seconds`
+static void play_autopilot_move(TetrisContext *ctx, double seconds) {
+    if (ctx->paused || ctx->current_fsm_state != TETRIS_STATE_MOVING || !ctx->current_piece.active) return;
+    TetrisAutopilotPlan *plan = &ctx->autopilot_plan;
+    if (plan->piece != ctx->pieces_spawned) {
+        TetrisBotMove move = tetris_bot_search(ctx->autopilot, ctx, true);
+        plan->piece = ctx->pieces_spawned;
+        plan->action_count = move.action_count;
+        memcpy(plan->actions, move.actions, sizeof(plan->actions));
+        plan->next_action = 0;
+        plan->wait = autopilot_delay(ctx, 0);
+    } else {
+        plan->wait -= seconds;
+    }
+    while (plan->next_action < plan->action_count && plan->wait <= TIME_EPSILON &&
+           plan->piece == ctx->pieces_spawned && ctx->current_fsm_state == TETRIS_STATE_MOVING) {
+        UserAction_t action = plan->actions[plan->next_action++];
+        tetris_input(ctx, action, false);
+        tetris_release(ctx, action);
+        if (plan->next_action < plan->action_count) plan->wait += autopilot_delay(ctx, plan->next_action);
+    }
+}
+
+void tetris_input(TetrisContext *ctx, UserAction_t action, bool hold) {
+    if (action == Autopilot) {
+        tetris_set_autopilot(ctx, ctx->autopilot == NULL);
+        return;
+    }
+
+    if (action == Terminate) {
+        ctx->current_fsm_state = TETRIS_STATE_GAME_OVER; // Or a specific terminate state
+        ctx->overall_game_state = TERMINATE_GAME;
+        tetris_set_autopilot(ctx, false);
+        if (ctx->score > ctx->high_score) { // Save score on terminate too
+             save_high_score_to_file(ctx);
+        }
+        return;
+    }
+
+    if (action == Start) {
+        if (ctx->current_fsm_state == TETRIS_STATE_START_SCREEN || ctx->current_fsm_state == TETRIS_STATE_GAME_OVER || ctx->overall_game_state == PAUSED) {
+            reset_game_state(ctx); // Resets board, score, level
+            load_high_score_from_file(ctx); // Ensure high score is fresh for new game
+            ctx->current_fsm_state = TETRIS_STATE_SPAWN;
+            ctx->overall_game_state = GAME_RUNNING;
+        }
+        return; // Start action consumes the input here
     }
     
-    GameInfo_t info;
-    info.field = NULL; // Initialize to NULL
-    info.next = NULL;  // Initialize to NULL
+    // Actions below are only valid if game is running and not on start/gameover screen
+    if (ctx->current_fsm_state == TETRIS_STATE_START_SCREEN || ctx->current_fsm_state == TETRIS_STATE_GAME_OVER) {
+        return;
+    }
+
+    if (action == Pause) {
+        ctx->paused = !ctx->paused;
+        if (ctx->paused) {
+            ctx->overall_game_state = PAUSED;
+        } else {
+            ctx->overall_game_state = GAME_RUNNING;
+            ctx->gravity_rows = 0.0; // Reset gravity on unpause to avoid instant drop
+        }
+        return;
+    }
+
+    if (ctx->paused) return; // No game actions if paused
+
+    if (action == Left || action == Right || action == Down) {
+        TetrisHeldKey *key = held_key(ctx, action);
+        if (hold && key->held && key->action == action) return; // Repeats come from tetris_advance()
+        press_key(ctx, key, action);
+    }
+    apply_action(ctx, action);
+}
 
-    if (!paused && overall_game_state != TERMINATE_GAME && overall_game_state != START_SCREEN && overall_game_state != GAME_OVER_LOSE) {
-        game_timer_ticks++;
+void tetris_release(TetrisContext *ctx, UserAction_t action) {
+    if (action != Left && action != Right && action != Down) return;
+    TetrisHeldKey *key = held_key(ctx, action);
+    if (key->action == action) key->held = false; // A release of the other shift key changes nothing
+}
 
+static void advance_game_state(TetrisContext *ctx) {
+    if (!ctx->paused && ctx->overall_game_state != TERMINATE_GAME && ctx->overall_game_state != START_SCREEN && ctx->overall_game_state != GAME_OVER_LOSE) {
         // --- FSM Logic ---
-        switch (current_fsm_state) {
+        switch (ctx->current_fsm_state) {
             case TETRIS_STATE_START_SCREEN:
                 // Waiting for Start action via userInput
-                overall_game_state = START_SCREEN;
+                ctx->overall_game_state = START_SCREEN;
                 break;
 
             case TETRIS_STATE_SPAWN:
-                spawn_new_piece(); // This can change state to MOVING or GAME_OVER
+                spawn_new_piece(ctx); // This can change state to MOVING or GAME_OVER
                 // If still SPAWN (should not happen if spawn_new_piece is correct) or changed to GAMEOVER
-                if (current_fsm_state == TETRIS_STATE_GAME_OVER) {
-                     overall_game_state = GAME_OVER_LOSE;
+                if (ctx->current_fsm_state == TETRIS_STATE_GAME_OVER) {
+                     ctx->overall_game_state = GAME_OVER_LOSE;
                 } else {
-                     current_fsm_state = TETRIS_STATE_MOVING; // Expected transition
-                     overall_game_state = GAME_RUNNING;
+                     ctx->current_fsm_state = TETRIS_STATE_MOVING; // Expected transition
+                     ctx->overall_game_state = GAME_RUNNING;
                 }
-                game_timer_ticks = 0;
                 break;
 
             case TETRIS_STATE_MOVING:
-                overall_game_state = GAME_RUNNING;
-                // Automatic downward movement (gravity)
-                // Check ticks against a threshold derived from game_speed_ms
-                // Assuming 60 "ticks" per second if updateCurrentState is called frequently enough
-                // Or, more simply, if game_speed_ms is the interval:
-                // This needs a proper timing mechanism. The CLI sleeps for game_speed_ms.
-                // So, each call to updateCurrentState can be considered one "major tick".
-                // Let's use a simpler model where game_speed_ms determines how many
-                // updateCurrentState calls happen before an auto-drop.
-                // If game_speed_ms is, say, 500ms, and updateCurrentState is called every 16ms (60FPS):
-                // 500 / 16 ~= 31 ticks.
-                // For now, let's assume the CLI loop's sleep(game_speed_ms) implies that
-                // each call to updateCurrentState is one "game step" for falling.
-                // This is simpler and matches the structure of many such games.
-                // So, every time updateCurrentState is called and we are in MOVING state, try to move down.
-
-                if (current_piece.active) {
-                    if (is_valid_position(current_piece.x, current_piece.y + 1, current_piece.type, current_piece.rotation)) {
-                        current_piece.y++;
+                ctx->overall_game_state = GAME_RUNNING;
+                // Gravity: one row per tick. tetris_advance() decides how many
+                // ticks the elapsed time is worth.
+
+                if (ctx->current_piece.active) {
+                    if (is_valid_position(ctx, ctx->current_piece.x, ctx->current_piece.y + 1, ctx->current_piece.type, ctx->current_piece.rotation)) {
+                        ctx->current_piece.y++;
                     } else {
-                        current_fsm_state = TETRIS_STATE_LOCKING;
+                        settle_piece(ctx);
                     }
                 } else { // Should not happen if logic is correct
-                    current_fsm_state = TETRIS_STATE_SPAWN;
+                    ctx->current_fsm_state = TETRIS_STATE_SPAWN;
                 }
                 break;
 
-            case TETRIS_STATE_LOCKING:
-                lock_current_piece(); // Changes state to LINE_CLEAR
-                // No break, fall through to LINE_CLEAR typically
-                // fallthrough intended
-
-            case TETRIS_STATE_LINE_CLEAR:
-                {
-                    int lines = clear_completed_lines();
-                    if (lines > 0) {
-                        update_score_and_level(lines);
-                    }
-                    current_fsm_state = TETRIS_STATE_SPAWN; // Get ready for next piece
-                }
-                break;
-            
             case TETRIS_STATE_GAME_OVER:
-                overall_game_state = GAME_OVER_LOSE;
+                ctx->overall_game_state = GAME_OVER_LOSE;
                 // Persist high score if it changed.
-                if (score > high_score) { // This might be redundant if saved on state change
-                    high_score = score;
-                    save_high_score_to_file();
+                if (ctx->score > ctx->high_score) { // This might be redundant if saved on state change
+                    ctx->high_score = ctx->score;
+                    save_high_score_to_file(ctx);
                 }
                 break;
         }
 
     
-    } else if (paused && overall_game_state != TERMINATE_GAME) {
-        overall_game_state = PAUSED;
-    } else if (overall_game_state == START_SCREEN) {
+    } else if (ctx->paused && ctx->overall_game_state != TERMINATE_GAME) {
+        ctx->overall_game_state = PAUSED;
+    } else if (ctx->overall_game_state == START_SCREEN) {
         // Do nothing, wait for start
-    } else if (overall_game_state == GAME_OVER_LOSE) {
+    } else if (ctx->overall_game_state == GAME_OVER_LOSE) {
         // Do nothing, wait for start
     }
+}
+
+static void render_frame(const TetrisContext *ctx, GameFrame_t *frame) {
+    composite_field(ctx, frame->info.field);
+    copy_next_piece_to_game_info_next(ctx, frame->info.next);
+
+    frame->info.score = ctx->score;
+    frame->info.high_score = ctx->high_score;
+    frame->info.level = ctx->level;
+    frame->info.speed = ctx->game_speed_ms;
+    frame->info.pause = ctx->paused ? 1 : 0;
+    frame->info.current_game_state = ctx->overall_game_state;
+    frame->landing_row = -1;
+    if (ctx->current_piece.active) {
+        const TetrominoLayout *layout = &tetromino_layouts[ctx->current_piece.type][ctx->current_piece.rotation];
+        frame->landing_row = ctx->current_piece.y + drop_distance(ctx) + layout->max_y;
+    }
+    frame->preview_count = tetris_preview(ctx, frame->preview, PREVIEW_LENGTH);
+}
+
+const TetrisBoardMetrics *tetris_metrics(const TetrisContext *ctx) {
+    return &ctx->board.metrics;
+}
+
+const TetrisLineClear *tetris_last_clear(const TetrisContext *ctx) {
+    return &ctx->last_clear;
+}
+
+int tetris_preview_piece(const TetrisContext *ctx, int index) {
+    return ctx->queue.ring[(ctx->queue.head + index) % TETRIS_PREVIEW_LENGTH];
+}
+
+int tetris_preview(const TetrisContext *ctx, int *types, int max) {
+    int count = max < TETRIS_PREVIEW_LENGTH ? max : TETRIS_PREVIEW_LENGTH;
+    for (int i = 0; i < count; ++i) {
+        types[i] = tetris_preview_piece(ctx, i);
+    }
+    return count;
+}
+
+void tetris_set_entry_delay(TetrisContext *ctx, int delay_ms) {
+    ctx->entry_delay_ms = delay_ms > 0 ? delay_ms : 0;
+}
+
+void tetris_set_auto_shift(TetrisContext *ctx, int das_ms, int arr_ms) {
+    ctx->das_ms = das_ms > 0 ? das_ms : 0;
+    ctx->arr_ms = arr_ms > 0 ? arr_ms : 0;
+}
+
+void tetris_set_ghost(TetrisContext *ctx, bool enabled) {
+    ctx->show_ghost = enabled;
+}
+
+bool tetris_piece_fits(const TetrisContext *ctx, int piece_x, int piece_y, int type, int rotation) {
+    return is_valid_position(ctx, piece_x, piece_y, type, rotation);
+}
+
+void tetris_step(TetrisContext *ctx) {
+    if (ctx->autopilot) play_autopilot_move(ctx, 1.0 / ctx->gravity); // A tick is one gravity period
+    advance_game_state(ctx);
+}
+
+void tetris_advance(TetrisContext *ctx, double seconds) {
+    if (seconds > MAX_UPDATE_NS / 1e9) seconds = MAX_UPDATE_NS / 1e9;
+    if (ctx->autopilot) play_autopilot_move(ctx, seconds);
+    if (ctx->current_fsm_state == TETRIS_STATE_SPAWN && ctx->entry_delay_left > 0.0 &&
+        !ctx->paused && ctx->overall_game_state == GAME_RUNNING) {
+        ctx->entry_delay_left -= seconds;
+        if (ctx->entry_delay_left > TIME_EPSILON) return;
+    }
+    if (ctx->paused || ctx->overall_game_state != GAME_RUNNING ||
+        ctx->current_fsm_state != TETRIS_STATE_MOVING) {
+        advance_game_state(ctx); // Spawning takes one tick
+        return;
+    }
+    repeat_held_key(ctx, &ctx->shift, seconds);
+    repeat_held_key(ctx, &ctx->soft_drop, seconds);
+    if (ctx->current_fsm_state != TETRIS_STATE_MOVING) return; // A repeated soft drop landed the piece
+    ctx->gravity_rows += seconds * ctx->gravity;
+    while (ctx->gravity_rows >= 1.0 - TIME_EPSILON && ctx->current_fsm_state == TETRIS_STATE_MOVING) {
+        ctx->gravity_rows -= 1.0;
+        advance_game_state(ctx);
+    }
+}
+
+void tetris_update(TetrisContext *ctx, uint64_t now_ns) {
+    uint64_t elapsed = ctx->clock_ns && now_ns > ctx->clock_ns ? now_ns - ctx->clock_ns : 0;
+    if (elapsed > MAX_UPDATE_NS) elapsed = MAX_UPDATE_NS;
+    ctx->clock_ns = now_ns;
+    tetris_advance(ctx, (double)elapsed / 1e9);
+}
+
+uint64_t tetris_clock_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+double tetris_gravity(const TetrisContext *ctx) {
+    return ctx->gravity;
+}
+
+void tetris_snapshot(const TetrisContext *ctx, GameFrame_t *frame) {
+    bindGameFrame(frame);
+    render_frame(ctx, frame);
+}
+
+const GameFrame_t *tetris_borrow_frame(TetrisContext *ctx) {
+    GameFrame_t *frame = acquireGameFrame(&ctx->frame_buffer);
+    if (frame) {
+        render_frame(ctx, frame);
+    }
+    return frame;
+}
+
+void tetris_release_frame(TetrisContext *ctx, const GameFrame_t *frame) {
+    releaseGameFrame(&ctx->frame_buffer, frame);
+}
+
+// --- Global API: thin wrappers around the default context ---
+
+void userInput(UserAction_t action, bool hold) {
+    tetris_input(default_tetris_context(), action, hold);
+}
+
+void releaseInput(UserAction_t action) {
+    tetris_release(default_tetris_context(), action);
+}
+
+const GameFrame_t *borrowCurrentState() {
+    TetrisContext *ctx = default_tetris_context();
+    tetris_update(ctx, tetris_clock_ns());
+    return tetris_borrow_frame(ctx);
+}
+
+void releaseCurrentState(const GameFrame_t *frame) {
+    tetris_release_frame(default_tetris_context(), frame);
+}
+
+void stepGame(double seconds) {
+    tetris_advance(default_tetris_context(), seconds);
+}
+
+const GameFrame_t *borrowSnapshot() {
+    return tetris_borrow_frame(default_tetris_context());
+}
 
+// Compatibility path: same update as borrowCurrentState(), but the caller gets
+// its own malloc'ed copy of the field and next arrays and must free them.
+GameInfo_t updateCurrentState() {
+    const GameFrame_t *frame = borrowCurrentState();
+
+    GameInfo_t info;
+    memset(&info, 0, sizeof(info));
+    if (!frame) return info; // Caller is still holding both frames
 
-    // --- Populate GameInfo_t ---
+    info = frame->info;
     info.field = allocate_game_info_field();
     info.next = allocate_game_info_next_piece_area();
 
     if (info.field) {
-        copy_board_to_game_info_field(info.field);
+        for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
+            memcpy(info.field[r], frame->field_cells[r], sizeof(frame->field_cells[r]));
+        }
     }
     if (info.next) {
-        copy_next_piece_to_game_info_next(info.next);
+        for (int r = 0; r < TETROMINO_GRID_SIZE; ++r) {
+            memcpy(info.next[r], frame->next_cells[r], sizeof(frame->next_cells[r]));
+        }
     }
 
-    info.score = score;
-    info.high_score = high_score;
-    info.level = level;
-    info.speed = game_speed_ms;
-    info.pause = paused ? 1 : 0;
-    info.current_game_state = overall_game_state;
-    
+    releaseCurrentState(frame);
     return info;
-}
\ No newline at end of file
+}
@@ -1,9 +1,16 @@
 #ifndef S21_TETRIS_H
 #define S21_TETRIS_H
 
-#include "../GameCommon.h" // Assuming GameCommon.h is in src/brick_game/
 #include <stdbool.h>     // For bool type in C
 #include <stdio.h>       // For FILE operations (high score)
+#include <stdint.h>      // For the seed type
+#include "../GameCommon.h" // Assuming GameCommon.h is in src/brick_game/
+#include "../GameRandom.h" // For the per-context piece generator
+
+#ifdef __cplusplus
+namespace s21 {
+extern "C" { // Lets the C++ tests and frontends link against the C engine
+#endif
 
 // --- Macros and Constants ---
 #define TETRIS_BOARD_WIDTH 10     // From GameCommon.h (10)
@@ -11,7 +18,22 @@
 #define TETROMINO_GRID_SIZE 4              // Max size of a tetromino bounding box (e.g., 4x4)
 #define NUM_TETROMINO_TYPES 7
 #define NUM_TETROMINO_ROTATIONS 4
+#define TETROMINO_CELL_COUNT 4 // Blocks in every tetromino
 #define HIGH_SCORE_FILENAME "tetris_highscore.txt"
+#define TETRIS_SPAWN_X (TETRIS_BOARD_WIDTH / 2 - TETROMINO_GRID_SIZE / 2) // New pieces start centered
+#define TETRIS_SPAWN_Y 0                                                  // at the top, in rotation 0
+#define TETRIS_PREVIEW_LENGTH PREVIEW_LENGTH // Upcoming pieces kept ready, see tetris_preview()
+#define TETRIS_DEFAULT_DAS_MS 167 // Hold before a shift starts repeating, see tetris_set_auto_shift()
+#define TETRIS_DEFAULT_ARR_MS 33  // Interval between repeated shifts and soft drops
+
+// Bitboard layout: one uint16_t per row, board column c is bit (c + TETRIS_WALL_BITS).
+// The bits left and right of the board are permanently set (walls) and
+// TETRIS_FLOOR_ROWS full rows below the board act as the floor, so a collision
+// test is one AND per piece row with no bounds checks.
+#define TETRIS_WALL_BITS 3
+#define TETRIS_FLOOR_ROWS TETROMINO_GRID_SIZE
+#define TETRIS_ROW_FULL 0xFFFFu
+#define TETRIS_ROW_EMPTY ((uint16_t)(TETRIS_ROW_FULL & ~(((1u << TETRIS_BOARD_WIDTH) - 1u) << TETRIS_WALL_BITS)))
 
 // --- Data Structures ---
 
@@ -22,6 +44,28 @@ typedef struct {
     // int height; // Actual height of the piece - can be derived if needed
 } TetrominoShape;
 
+// Precomputed geometry of one tetromino rotation inside its 4x4 grid
+typedef struct {
+    int8_t cells[TETROMINO_CELL_COUNT][2];      // (column, row) of each block, row-major order
+    uint16_t row_masks[TETROMINO_GRID_SIZE];    // Bit c set when column c of the row is a block
+    int8_t min_x, max_x, min_y, max_y;          // Bounding box of the blocks
+    int8_t column_bottom[TETROMINO_GRID_SIZE];  // Lowest block row per column, -1 if the column is empty
+} TetrominoLayout;
+
+// Both tables are generated at compile time from one cell list in tetris.c
+extern const TetrominoLayout tetromino_layouts[NUM_TETROMINO_TYPES][NUM_TETROMINO_ROTATIONS];
+extern const TetrominoShape tetrominoes[NUM_TETROMINO_TYPES][NUM_TETROMINO_ROTATIONS];
+
+// 7-bag piece generator: every run of seven pieces drawn from a bag holds
+// each tetromino once. The next TETRIS_PREVIEW_LENGTH pieces are drawn ahead
+// into a ring, so the preview costs nothing to read.
+typedef struct {
+    int8_t ring[TETRIS_PREVIEW_LENGTH]; // Upcoming pieces; ring[head] spawns next
+    int8_t bag[NUM_TETROMINO_TYPES];    // The current bag; its first bag_left entries are undrawn
+    int head;
+    int bag_left;
+} TetrisPieceQueue;
+
 // State of the current falling piece
 typedef struct {
     int x;          // x-coordinate (column) of the top-left of the piece's 4x4 grid on the board
@@ -31,17 +75,418 @@ typedef struct {
     bool active;    // Is there a piece currently falling?
 } CurrentPieceState;
 
+// Stack shape metrics, kept up to date on every lock and line clear.
+// Heights count from the floor; a hole is an empty cell below the top block
+// of its column; a well is how far a column sits below both neighbours
+// (the walls count as full height).
+typedef struct {
+    int heights[TETRIS_BOARD_WIDTH];
+    int holes[TETRIS_BOARD_WIDTH];
+    int well_depths[TETRIS_BOARD_WIDTH];
+    int aggregate_height;  // Sum of heights
+    int total_holes;       // Sum of holes
+    int bumpiness;         // Sum of |height difference| of adjacent columns
+} TetrisBoardMetrics;
+
+// Rows removed by one line clear, as board row indices before the clear
+typedef struct {
+    int count;                      // Number of rows cleared (0-4)
+    int rows[TETROMINO_GRID_SIZE];  // Cleared rows, bottom-most first
+} TetrisLineClear;
+
+// Locked blocks of one playfield plus everything derived from them. Kept
+// separate from TetrisContext so planners can copy and mutate boards cheaply.
+typedef struct {
+    uint16_t rows[TETRIS_BOARD_HEIGHT + TETRIS_FLOOR_ROWS]; // Bitboard, see TETRIS_WALL_BITS
+    uint32_t column_masks[TETRIS_BOARD_WIDTH]; // Same blocks by column: bit r set when row r is filled
+    TetrisBoardMetrics metrics;                // Derived from column_masks
+} TetrisBoard;
+
+// A movement key the player holds down. Repeats are timed by tetris_advance(),
+// not by how often the frontend sees the key.
+typedef struct {
+    UserAction_t action;  // Left, Right or Down
+    bool held;            // Pressed and not yet released
+    double held_for;      // Seconds since the press
+    double next_repeat;   // held_for at which the next repeat is due
+} TetrisHeldKey;
+
+// Placement search bot, see tetris_bot.h
+typedef struct TetrisBot TetrisBot;
+
+// Longest move a bot can return: two rotations, a full sweep across the
+// board and the hard drop, with room to spare
+#define TETRIS_BOT_MAX_ACTIONS 16
+
+// Move the autopilot is playing out, one action at a time
+typedef struct {
+    unsigned long piece;       // pieces_spawned the move was planned for, 0 for none
+    int action_count;
+    int next_action;           // Index of the next action to play
+    double wait;               // Seconds until the next action is due
+    UserAction_t actions[TETRIS_BOT_MAX_ACTIONS];
+} TetrisAutopilotPlan;
+
 // Internal Tetris FSM states (more granular than GameState from GameCommon.h)
 typedef enum {
     TETRIS_STATE_START_SCREEN,  // Initial state, waiting for Start action
     TETRIS_STATE_SPAWN,         // Spawning a new piece
     TETRIS_STATE_MOVING,        // Piece is falling and can be controlled by player
-    TETRIS_STATE_LOCKING,       // Piece has landed, locking it to the board
-    TETRIS_STATE_LINE_CLEAR,    // Checking and clearing lines
     TETRIS_STATE_GAME_OVER      // Game over state
 } TetrisFSMState_t;
 
+// Complete state of one Tetris game. Contexts share nothing with each other,
+// so independent boards can be stepped concurrently from different threads.
+// Treat the fields as private and go through the tetris_* functions.
+typedef struct {
+    TetrisBoard board;                   // Locked blocks, see tetris_metrics()
+    CurrentPieceState current_piece;
+    TetrisLineClear last_clear;          // Rows removed when the last piece locked
+    TetrisPieceQueue queue;              // Upcoming pieces, see tetris_preview()
+    int score;
+    int high_score;
+    int level;
+    int game_speed_ms;                   // Gravity period of the level; lower is faster
+    double gravity;                      // Rows per second the falling piece drops
+    double gravity_rows;                 // Rows of gravity owed, see tetris_advance()
+    uint64_t clock_ns;                   // Time of the last tetris_update(), 0 before the first
+    int entry_delay_ms;                  // Wait between a lock and the next spawn, see tetris_set_entry_delay()
+    double entry_delay_left;             // Seconds of the current entry delay still to wait
+    int das_ms;                          // Delayed auto shift, see tetris_set_auto_shift()
+    int arr_ms;                          // Auto-repeat rate; 0 repeats instantly
+    TetrisHeldKey shift;                 // Left or Right, whichever was pressed last
+    TetrisHeldKey soft_drop;             // Down
+    bool paused;
+    bool show_ghost;                     // Composite the landing preview into snapshots
+    TetrisFSMState_t current_fsm_state;
+    GameState overall_game_state;        // For GameInfo_t
+    int lines_cleared_for_level_up;
+    const char *high_score_path;         // NULL keeps the high score in memory
+    GameRandom_t rng;                    // Piece generator, see tetris_seed()
+    GameFrameBuffer_t frame_buffer;      // Engine-owned frames for tetris_borrow_frame()
+    TetrisBot *autopilot;                // Plays each new piece while set, see tetris_set_autopilot()
+    TetrisAutopilotPlan autopilot_plan;  // What the autopilot is playing for the falling piece
+    unsigned long pieces_spawned;        // Since tetris_init(); tells the autopilot a piece is new
+} TetrisContext;
+
+// --- Board API ---
+
+/**
+ * @brief Empties a board: walls and floor only, all metrics zero.
+ *
+ * @param board The board to reset.
+ */
+void tetris_board_reset(TetrisBoard *board);
+
+/**
+ * @brief Tests whether a piece fits a board at the given position.
+ *
+ * @param board The board to test against.
+ * @param piece_x Column of the piece's 4x4 grid on the board.
+ * @param piece_y Row of the piece's 4x4 grid on the board.
+ * @param type Tetromino type (0-6).
+ * @param rotation Rotation index (0-3).
+ * @return true if the piece overlaps neither walls, floor nor locked blocks.
+ */
+bool tetris_board_fits(const TetrisBoard *board, int piece_x, int piece_y, int type, int rotation);
+
+/**
+ * @brief Rotates a piece one step with SRS wall kicks.
+ *
+ * The kick offsets of the rotation are tried in order, each as one
+ * tetris_board_fits() test, and the first position that fits is taken.
+ *
+ * @param board The board to rotate on.
+ * @param type Tetromino type (0-6).
+ * @param piece_x In/out: column of the piece's 4x4 grid.
+ * @param piece_y In/out: row of the piece's 4x4 grid.
+ * @param rotation In/out: rotation index (0-3).
+ * @param direction 1 for clockwise, -1 for counter-clockwise.
+ * @return true if the piece rotated; false leaves the position unchanged.
+ */
+bool tetris_board_rotate(const TetrisBoard *board, int type, int *piece_x, int *piece_y, int *rotation,
+                         int direction);
+
+/**
+ * @brief Counts the rows a fitting piece can fall before it comes to rest.
+ *
+ * Parameters as for tetris_board_fits().
+ * @return Rows between the piece and the stack or floor beneath it.
+ */
+int tetris_board_drop_distance(const TetrisBoard *board, int piece_x, int piece_y, int type, int rotation);
+
+/**
+ * @brief Locks a piece into a board and updates the affected metrics.
+ *
+ * Parameters as for tetris_board_fits(); the piece is expected to fit.
+ */
+void tetris_board_place(TetrisBoard *board, int piece_x, int piece_y, int type, int rotation);
+
+/**
+ * @brief Removes all full rows, letting the rows above fall.
+ *
+ * @param board The board to compact.
+ * @return The rows that were removed.
+ */
+TetrisLineClear tetris_board_clear_lines(TetrisBoard *board);
+
+// --- Context API ---
+
+/**
+ * @brief Initializes a caller-allocated context to the start screen.
+ *
+ * Whatever the memory held before is overwritten, so use tetris_reset() on
+ * a context that is already initialized.
+ *
+ * The piece generator is seeded from the clock; call tetris_seed() afterwards
+ * for a reproducible game.
+ *
+ * @param ctx The context to initialize.
+ * @param high_score_path File the high score is loaded from and saved to, or
+ * NULL to keep it in memory only. The string must outlive the context.
+ */
+void tetris_init(TetrisContext *ctx, const char *high_score_path);
+
+/**
+ * @brief Stops the autopilot of an initialized context and initializes it
+ * again, keeping its high score path.
+ *
+ * @param ctx The context to reset.
+ */
+void tetris_reset(TetrisContext *ctx);
+
+/**
+ * @brief Reseeds the piece generator and returns to the start screen.
+ *
+ * The same seed and the same sequence of inputs and steps always produce the
+ * same game, which makes replays and benchmarks reproducible.
+ *
+ * @param ctx The context to reseed.
+ * @param seed Seed of the piece generator.
+ */
+void tetris_seed(TetrisContext *ctx, uint64_t seed);
+
+/**
+ * @brief Allocates and initializes a new, independent game.
+ *
+ * @param high_score_path See tetris_init().
+ * @return TetrisContext* The new context, or NULL if allocation failed.
+ */
+TetrisContext *tetris_create(const char *high_score_path);
+
+/**
+ * @brief Frees a context created with tetris_create().
+ *
+ * @param ctx The context to destroy (may be NULL).
+ */
+void tetris_destroy(TetrisContext *ctx);
+
+/**
+ * @brief Applies a user action to one game (see userInput()).
+ *
+ * A press of Left, Right or Down moves the piece at once and keeps the key
+ * held until tetris_release(); tetris_advance() then repeats the move on its
+ * own schedule (see tetris_set_auto_shift()). Reports of a key that is
+ * already held, such as OS key repeats, only keep it held.
+ *
+ * @param ctx The game to control.
+ * @param action The user action.
+ * @param hold false for a press, true while the key is held down.
+ */
+void tetris_input(TetrisContext *ctx, UserAction_t action, bool hold);
+
+/**
+ * @brief Releases a key pressed through tetris_input(), ending its repeats.
+ *
+ * @param ctx The game to control.
+ * @param action The released action; only Left, Right and Down repeat.
+ */
+void tetris_release(TetrisContext *ctx, UserAction_t action);
+
+/**
+ * @brief Advances one game by a single FSM tick (gravity, locking, spawning).
+ *
+ * A tick drops the falling piece one row regardless of the level; use
+ * tetris_advance() or tetris_update() for real-time play.
+ *
+ * @param ctx The game to advance.
+ */
+void tetris_step(TetrisContext *ctx);
+
+/**
+ * @brief Advances one game by a span of time.
+ *
+ * While a piece falls, gravity accumulates tetris_gravity() rows per second
+ * and the piece drops one row per whole row owed, several in one call if the
+ * span is long enough. The tick a piece lands in also locks it, clears lines
+ * and spawns the next piece, unless an entry delay is set; the delay then
+ * runs down over the following calls. Held movement keys repeat before
+ * gravity is applied. Any other state advances one tick per
+ * call, as with tetris_step(). How often this is called only
+ * affects input latency, not the speed of the game.
+ *
+ * @param ctx The game to advance.
+ * @param seconds Time elapsed since the previous call, capped at one second.
+ */
+void tetris_advance(TetrisContext *ctx, double seconds);
+
+/**
+ * @brief Advances one game to a point on the monotonic clock.
+ *
+ * The first call only starts the clock. Later calls hand the time elapsed
+ * since the previous one, capped at one second, to tetris_advance().
+ *
+ * @param ctx The game to advance.
+ * @param now_ns Reading of tetris_clock_ns() or any other monotonic clock.
+ */
+void tetris_update(TetrisContext *ctx, uint64_t now_ns);
+
+/**
+ * @brief Reads the monotonic clock used by the global API.
+ *
+ * @return uint64_t Nanoseconds since an arbitrary fixed point.
+ */
+uint64_t tetris_clock_ns(void);
+
+/**
+ * @brief Gravity of the current level.
+ *
+ * @param ctx The game to query.
+ * @return double Rows per second the falling piece drops.
+ */
+double tetris_gravity(const TetrisContext *ctx);
+
+/**
+ * @brief Returns the stack metrics of the locked blocks.
+ *
+ * The metrics are maintained incrementally, so this is O(1).
+ *
+ * @param ctx The game to query.
+ * @return Column heights, holes, wells and their aggregates.
+ */
+const TetrisBoardMetrics *tetris_metrics(const TetrisContext *ctx);
+
+/**
+ * @brief Reports the rows removed when the last piece locked.
+ *
+ * @param ctx The game to query.
+ * @return The line clear of the most recent lock; count is 0 if it cleared nothing.
+ */
+const TetrisLineClear *tetris_last_clear(const TetrisContext *ctx);
+
+/**
+ * @brief Returns an upcoming piece without drawing it.
+ *
+ * @param ctx The game to query.
+ * @param index 0 for the piece that spawns next, up to TETRIS_PREVIEW_LENGTH - 1.
+ * @return Tetromino type (0-6).
+ */
+int tetris_preview_piece(const TetrisContext *ctx, int index);
+
+/**
+ * @brief Copies the upcoming pieces, soonest first.
+ *
+ * @param ctx The game to query.
+ * @param types Destination for up to max types.
+ * @param max Capacity of types.
+ * @return Number of types written, at most TETRIS_PREVIEW_LENGTH.
+ */
+int tetris_preview(const TetrisContext *ctx, int *types, int max);
+
+/**
+ * @brief Sets the entry delay between locking a piece and spawning the next.
+ *
+ * The delay is measured by tetris_advance() and tetris_update();
+ * tetris_step() spawns on the next tick regardless. 0 (the default) spawns
+ * in the same tick the previous piece locks.
+ *
+ * @param ctx The game to configure.
+ * @param delay_ms Delay in milliseconds; negative values count as 0.
+ */
+void tetris_set_entry_delay(TetrisContext *ctx, int delay_ms);
+
+/**
+ * @brief Sets how held movement keys repeat.
+ *
+ * A held Left or Right shifts again after das_ms and then every arr_ms; a
+ * held Down soft drops every arr_ms from the press. An arr_ms of 0 moves the
+ * piece as far as it goes at once. Repeats are measured by tetris_advance()
+ * and tetris_update(); tetris_step() never repeats.
+ *
+ * @param ctx The game to configure.
+ * @param das_ms Delayed auto shift in milliseconds (default TETRIS_DEFAULT_DAS_MS).
+ * @param arr_ms Auto-repeat rate in milliseconds (default TETRIS_DEFAULT_ARR_MS).
+ * Negative values count as 0.
+ */
+void tetris_set_auto_shift(TetrisContext *ctx, int das_ms, int arr_ms);
+
+/**
+ * @brief Enables or disables the ghost piece in rendered frames.
+ *
+ * When enabled, the cells where the falling piece would land are reported
+ * as GHOST. Disabled by default.
+ *
+ * @param ctx The game to configure.
+ * @param enabled true to draw the ghost piece.
+ */
+void tetris_set_ghost(TetrisContext *ctx, bool enabled);
+
+/**
+ * @brief Hands the game over to the built-in bot, or takes it back.
+ *
+ * While enabled, the bot searches once for the best placement of every new
+ * piece (looking one piece ahead) and plays it through tetris_input() as
+ * rotations and shifts, one per auto-repeat interval, then hard drops one
+ * gravity period after the last of them. tetris_advance() times the actions,
+ * and a tetris_step() counts as one gravity period, so pieces land at the
+ * game's pace however often the caller ticks. The Autopilot action toggles
+ * this mode, and Terminate turns it off. The bot searches on
+ * the calling thread only, so many games can run autopilot side by side.
+ *
+ * @param ctx The game to configure.
+ * @param enabled true to let the bot play.
+ */
+void tetris_set_autopilot(TetrisContext *ctx, bool enabled);
+
+/**
+ * @brief Tests whether a piece fits the board at the given position.
+ *
+ * @param ctx The game whose board is tested.
+ * @param piece_x Column of the piece's 4x4 grid on the board.
+ * @param piece_y Row of the piece's 4x4 grid on the board.
+ * @param type Tetromino type (0-6).
+ * @param rotation Rotation index (0-3).
+ * @return true if the piece overlaps neither walls, floor nor locked blocks.
+ */
+bool tetris_piece_fits(const TetrisContext *ctx, int piece_x, int piece_y, int type, int rotation);
+
+/**
+ * @brief Renders one game into a caller-supplied frame without changing it.
+ *
+ * @param ctx The game to render.
+ * @param frame Destination frame; its GameInfo_t is pointed at its own cells.
+ */
+void tetris_snapshot(const TetrisContext *ctx, GameFrame_t *frame);
+
+/**
+ * @brief Renders one game into one of its own double-buffered frames.
+ *
+ * @param ctx The game to render.
+ * @return const GameFrame_t* The frame, valid until tetris_release_frame(), or
+ * NULL if both frames are still held.
+ */
+const GameFrame_t *tetris_borrow_frame(TetrisContext *ctx);
+
+/**
+ * @brief Returns a frame obtained from tetris_borrow_frame().
+ *
+ * @param ctx The game the frame belongs to.
+ * @param frame The frame to release.
+ */
+void tetris_release_frame(TetrisContext *ctx, const GameFrame_t *frame);
+
 // --- Game Logic API (to be called by the GUI) ---
+// These drive a lazily initialized default context.
 
 /**
  * @brief Processes user input and updates the game state machine.
@@ -51,17 +496,31 @@ typedef enum {
  * pausing, or starting/terminating the game.
  *
  * @param action The user action (e.g., Left, Right, Rotate, Start, Pause).
- * @param hold Indicates if the action key is being held down (currently not fully utilized by CLI).
+ * @param hold false for a key press, true for repeats while the key is held
+ * down. Held Left, Right and Down keys repeat until releaseInput().
  */
 void userInput(UserAction_t action, bool hold);
 
+/**
+ * @brief Reports that a key sent through userInput() was released.
+ *
+ * Frontends that cannot see key releases send every key as a press
+ * followed by a release.
+ *
+ * @param action The released action.
+ */
+void releaseInput(UserAction_t action);
+
 /**
  * @brief Updates the game state and returns all information needed for rendering.
  *
  * This function is called repeatedly by the GUI's game loop. It handles
  * automatic piece falling (gravity), checks for game events like landing a piece,
- * clearing lines, leveling up, and game over conditions.
+ * clearing lines, leveling up, and game over conditions. Gravity follows the
+ * monotonic clock (see tetris_update()), so calling it more often lowers
+ * input latency without speeding the game up.
  *
+ * Compatibility path: prefer borrowCurrentState()/releaseCurrentState().
  * It allocates memory for 'field' and 'next' members of GameInfo_t.
  * The caller (GUI) is responsible for freeing this memory after use to prevent leaks.
  * Example:
@@ -77,6 +536,42 @@ void userInput(UserAction_t action, bool hold);
  */
 GameInfo_t updateCurrentState();
 
+/**
+ * @brief Zero-allocation variant of updateCurrentState().
+ *
+ * Advances the game exactly like updateCurrentState(), but renders into one of
+ * two engine-owned frames instead of allocating. The frame stays valid until it
+ * is handed back with releaseCurrentState().
+ *
+ * @return const GameFrame_t* The rendered frame, or NULL if the caller still
+ * holds both frames.
+ */
+const GameFrame_t *borrowCurrentState();
+
+/**
+ * @brief Returns a frame obtained from borrowCurrentState() to the engine.
+ *
+ * @param frame The frame to release.
+ */
+void releaseCurrentState(const GameFrame_t *frame);
+
+/**
+ * @brief Advances the game by a span of time (see tetris_advance()).
+ *
+ * @param seconds Time elapsed since the previous step.
+ */
+void stepGame(double seconds);
+
+/**
+ * @brief Renders the game into an engine-owned frame without advancing it.
+ *
+ * Renderers can call this at any rate without changing the game's speed.
+ *
+ * @return const GameFrame_t* The frame, valid until releaseCurrentState(), or
+ * NULL if the caller still holds both frames.
+ */
+const GameFrame_t *borrowSnapshot();
+
 
 // --- Potentially useful internal functions that could be exposed if needed, ---
 // --- but typically would be static in tetris.c                       ---
@@ -88,4 +583,9 @@ GameInfo_t updateCurrentState();
  */
 void initialize_tetris_game(); // Made non-static for potential direct call if needed for testing/setup
 
-#endif // S21_TETRIS_H
\ No newline at end of file
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace s21
+#endif
+
+#endif // S21_TETRIS_H
@@ -0,0 +1,563 @@
+#define _POSIX_C_SOURCE 200809L // For sysconf()
+
+#include "tetris_bot.h"
+#include <float.h>      // For DBL_MAX
+#include <stdatomic.h>  // For the shared job cursor and counters
+#include <stdlib.h>     // For malloc, free
+#include <string.h>     // For memcmp, memcpy
+#include <threads.h>    // For the worker pool
+#include <unistd.h>     // For sysconf
+
+// Every rotation at every column, the upper bound of distinct placements
+#define MAX_PLACEMENTS (NUM_TETROMINO_ROTATIONS * (TETRIS_BOARD_WIDTH + TETROMINO_GRID_SIZE))
+
+// Score given to a placement after which the next piece cannot spawn
+#define LOST_SCORE (-DBL_MAX)
+
+// Zobrist keys are drawn from this seed, so hashes repeat between runs
+#define ZOBRIST_SEED 0x5A0B215EEDull
+
+// Deepest transposition table tetris_bot_set_beam() accepts
+#define MAX_TABLE_BITS 30
+
+const TetrisBotBeam tetris_bot_default_beam = {
+    .width = 64,
+    .depth = 3,
+    .table_bits = 16,
+};
+
+const TetrisBotWeights tetris_bot_default_weights = {
+    .aggregate_height = -0.510066,
+    .lines = 0.760666,
+    .holes = -0.35663,
+    .bumpiness = -0.184483,
+};
+
+// One reachable final position of a piece
+typedef struct {
+    int x;
+    int y;
+    int rotation;
+    int turns;      // Rotations from the starting rotation, negative for counter-clockwise
+    int kick_x;     // Column after the rotations and their wall kicks
+} Placement;
+
+// One state of the beam: a board and the path that led to it
+typedef struct {
+    TetrisBoard board;
+    uint64_t hash;   // Zobrist hash of the board's cells
+    double score;    // Heuristic score of the board and every line on the path
+    int lines;       // Lines cleared along the path
+    int root;        // Index of the path's first placement
+    bool merged;     // Superseded by a better path to the same board
+} BeamNode;
+
+// Transposition table slot; only entries stamped with the current depth count
+typedef struct {
+    uint64_t key;
+    uint32_t stamp;
+    int32_t node;
+} TableEntry;
+
+// A child of the beam waiting to be ranked
+typedef struct {
+    double score;
+    int index;
+} Ranked;
+
+struct TetrisBot;
+typedef void (*BotJob)(struct TetrisBot *bot);
+
+struct TetrisBot {
+    TetrisBotWeights weights;
+    int thread_count;
+    thrd_t *workers;           // thread_count - 1 helpers; the caller is the last thread
+    int worker_slots;          // Length of workers: the requested threads less the caller
+    mtx_t lock;
+    cnd_t wake;                // Signalled when a new search is published or on shutdown
+    cnd_t done;                // Signalled when the last helper finishes a search
+    bool stopping;
+    unsigned long generation;  // Incremented for every search
+    int busy;                  // Helpers still working on the current search
+    BotJob job;                // What the threads run for the current search
+
+    // The current search, read-only while the helpers run
+    const TetrisBoard *board;
+    int type;
+    int next_type;             // -1 without lookahead
+    int count;
+    Placement placements[MAX_PLACEMENTS];
+    double scores[MAX_PLACEMENTS];
+    atomic_int cursor;         // Next placement to score
+    atomic_ullong evaluations;
+
+    // Beam search state, sized by tetris_bot_set_beam()
+    TetrisBotBeam beam_shape;
+    uint64_t zobrist[TETRIS_BOARD_HEIGHT][TETRIS_BOARD_WIDTH];
+    const int *pieces;         // Piece played at every depth of the plan
+    int depth;                 // Depth being expanded
+    Placement roots[MAX_PLACEMENTS];
+    int root_count;
+    BeamNode *beam;            // beam_shape.width states
+    int beam_count;
+    BeamNode *children;        // MAX_PLACEMENTS slots per beam state
+    int *child_counts;         // Children written by every beam state
+    Ranked *ranked;            // Surviving children, best first
+    TableEntry *table;
+    uint32_t stamp;
+    unsigned long long transpositions;
+};
+
+// --- Placement Enumeration ---
+
+static bool same_layout(const TetrominoLayout *a, const TetrominoLayout *b) {
+    return a->min_x == b->min_x && a->min_y == b->min_y &&
+           memcmp(a->row_masks, b->row_masks, sizeof(a->row_masks)) == 0;
+}
+
+// Rotations tried from the starting one: none, one and two clockwise turns,
+// then one counter-clockwise turn
+static const int rotation_turns[NUM_TETROMINO_ROTATIONS] = {0, 1, 2, -1};
+
+// Lists the placements reachable from (x, y, rotation) the way a player
+// reaches them: rotate (with wall kicks), shift sideways, hard drop.
+// Rotations whose shape repeats an earlier one (O) are skipped.
+static int enumerate_placements(const TetrisBoard *board, int type, int x, int y, int rotation,
+                                Placement *out) {
+    if (!tetris_board_fits(board, x, y, type, rotation)) return 0;
+    int count = 0;
+    int reached[NUM_TETROMINO_ROTATIONS];
+    int reached_count = 0;
+    for (int t = 0; t < NUM_TETROMINO_ROTATIONS; ++t) {
+        int turns = rotation_turns[t];
+        int kx = x, ky = y, rot = rotation;
+        bool rotated = true;
+        for (int i = 0; i < abs(turns) && rotated; ++i) {
+            rotated = tetris_board_rotate(board, type, &kx, &ky, &rot, turns < 0 ? -1 : 1);
+        }
+        if (!rotated) continue;
+        bool duplicate = false;
+        for (int k = 0; k < reached_count && !duplicate; ++k) {
+            duplicate = same_layout(&tetromino_layouts[type][reached[k]], &tetromino_layouts[type][rot]);
+        }
+        if (duplicate) continue;
+        reached[reached_count++] = rot;
+
+        int left = kx;
+        while (tetris_board_fits(board, left - 1, ky, type, rot)) --left;
+        for (int col = left; tetris_board_fits(board, col, ky, type, rot); ++col) {
+            out[count].x = col;
+            out[count].y = ky + tetris_board_drop_distance(board, col, ky, type, rot);
+            out[count].rotation = rot;
+            out[count].turns = turns;
+            out[count].kick_x = kx;
+            ++count;
+        }
+    }
+    return count;
+}
+
+// --- Evaluation ---
+
+static double board_score(const TetrisBotWeights *w, const TetrisBoard *board, int lines) {
+    const TetrisBoardMetrics *m = &board->metrics;
+    return w->aggregate_height * m->aggregate_height + w->lines * lines +
+           w->holes * m->total_holes + w->bumpiness * m->bumpiness;
+}
+
+// Zobrist hash of every locked cell on the board
+static uint64_t board_hash(const TetrisBot *bot, const TetrisBoard *board) {
+    uint64_t hash = 0;
+    for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
+        unsigned cells = (unsigned)(board->rows[r] & ~TETRIS_ROW_EMPTY) >> TETRIS_WALL_BITS;
+        while (cells) {
+            hash ^= bot->zobrist[r][__builtin_ctz(cells)];
+            cells &= cells - 1;
+        }
+    }
+    return hash;
+}
+
+// Plays one placement on a copy of the parent's board. Without a line clear
+// the hash changes by the four placed cells only.
+static void expand_node(const TetrisBot *bot, const BeamNode *parent, int type, const Placement *p,
+                        int root, BeamNode *child) {
+    child->board = parent->board;
+    tetris_board_place(&child->board, p->x, p->y, type, p->rotation);
+    int lines = tetris_board_clear_lines(&child->board).count;
+    if (lines == 0) {
+        const TetrominoLayout *layout = &tetromino_layouts[type][p->rotation];
+        child->hash = parent->hash;
+        for (int i = 0; i < TETROMINO_CELL_COUNT; ++i) {
+            child->hash ^= bot->zobrist[p->y + layout->cells[i][1]][p->x + layout->cells[i][0]];
+        }
+    } else {
+        child->hash = board_hash(bot, &child->board);
+    }
+    child->lines = parent->lines + lines;
+    child->score = board_score(&bot->weights, &child->board, child->lines);
+    child->root = root;
+    child->merged = false;
+}
+
+// Scores one placement of the current piece, counting every board it scored
+static double score_placement(const TetrisBot *bot, const Placement *p, unsigned long long *evaluations) {
+    TetrisBoard after = *bot->board;
+    tetris_board_place(&after, p->x, p->y, bot->type, p->rotation);
+    int lines = tetris_board_clear_lines(&after).count;
+    ++*evaluations;
+    if (bot->next_type < 0) {
+        return board_score(&bot->weights, &after, lines);
+    }
+
+    Placement follow_ups[MAX_PLACEMENTS];
+    int count = enumerate_placements(&after, bot->next_type, TETRIS_SPAWN_X, TETRIS_SPAWN_Y, 0, follow_ups);
+    double best = LOST_SCORE;
+    for (int i = 0; i < count; ++i) {
+        TetrisBoard next = after;
+        tetris_board_place(&next, follow_ups[i].x, follow_ups[i].y, bot->next_type, follow_ups[i].rotation);
+        int next_lines = tetris_board_clear_lines(&next).count;
+        double score = board_score(&bot->weights, &next, lines + next_lines);
+        if (score > best) best = score;
+    }
+    *evaluations += (unsigned long long)count;
+    return best;
+}
+
+// Scores placements until none are left; run by the caller and every helper
+static void run_jobs(TetrisBot *bot) {
+    unsigned long long evaluations = 0;
+    int i;
+    while ((i = atomic_fetch_add(&bot->cursor, 1)) < bot->count) {
+        bot->scores[i] = score_placement(bot, &bot->placements[i], &evaluations);
+    }
+    atomic_fetch_add(&bot->evaluations, evaluations);
+}
+
+// Expands beam states until none are left; run by the caller and every helper
+static void expand_jobs(TetrisBot *bot) {
+    unsigned long long evaluations = 0;
+    int type = bot->pieces[bot->depth];
+    Placement local[MAX_PLACEMENTS];
+    int i;
+    while ((i = atomic_fetch_add(&bot->cursor, 1)) < bot->beam_count) {
+        const BeamNode *parent = &bot->beam[i];
+        const Placement *placements = bot->roots;
+        int count = bot->root_count;
+        if (bot->depth > 0) {
+            placements = local;
+            count = enumerate_placements(&parent->board, type, TETRIS_SPAWN_X, TETRIS_SPAWN_Y, 0, local);
+        }
+        BeamNode *children = &bot->children[(size_t)i * MAX_PLACEMENTS];
+        for (int k = 0; k < count; ++k) {
+            expand_node(bot, parent, type, &placements[k], bot->depth == 0 ? k : parent->root,
+                        &children[k]);
+        }
+        bot->child_counts[i] = count;
+        evaluations += (unsigned long long)count;
+    }
+    atomic_fetch_add(&bot->evaluations, evaluations);
+}
+
+static int worker_main(void *arg) {
+    TetrisBot *bot = (TetrisBot *)arg;
+    unsigned long seen = 0;
+    mtx_lock(&bot->lock);
+    for (;;) {
+        while (!bot->stopping && bot->generation == seen) {
+            cnd_wait(&bot->wake, &bot->lock);
+        }
+        if (bot->stopping) break;
+        seen = bot->generation;
+        mtx_unlock(&bot->lock);
+
+        bot->job(bot);
+
+        mtx_lock(&bot->lock);
+        if (--bot->busy == 0) cnd_signal(&bot->done);
+    }
+    mtx_unlock(&bot->lock);
+    return 0;
+}
+
+// Runs a job on every thread of the bot and waits for all of them
+static void run_on_all_threads(TetrisBot *bot, BotJob job) {
+    mtx_lock(&bot->lock);
+    bot->job = job;
+    bot->generation++;
+    bot->busy = bot->thread_count - 1;
+    cnd_broadcast(&bot->wake);
+    mtx_unlock(&bot->lock);
+    job(bot);
+    mtx_lock(&bot->lock);
+    while (bot->busy > 0) {
+        cnd_wait(&bot->done, &bot->lock);
+    }
+    mtx_unlock(&bot->lock);
+}
+
+// --- Beam Selection ---
+
+// Best score first; equal scores keep the order the children were made in
+static int compare_ranked(const void *a, const void *b) {
+    const Ranked *x = (const Ranked *)a;
+    const Ranked *y = (const Ranked *)b;
+    if (x->score != y->score) return x->score < y->score ? 1 : -1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+// Merges children that reached the same board, then keeps the best of the
+// rest as the new beam. Returns the number kept, 0 if no child was made.
+static int select_beam(TetrisBot *bot) {
+    if (++bot->stamp == 0) { // Stamps wrapped, forget every entry
+        memset(bot->table, 0, sizeof(TableEntry) << bot->beam_shape.table_bits);
+        bot->stamp = 1;
+    }
+    uint64_t mask = ((uint64_t)1 << bot->beam_shape.table_bits) - 1;
+    for (int i = 0; i < bot->beam_count; ++i) {
+        for (int k = 0; k < bot->child_counts[i]; ++k) {
+            int index = i * MAX_PLACEMENTS + k;
+            BeamNode *child = &bot->children[index];
+            TableEntry *entry = &bot->table[child->hash & mask];
+            if (entry->stamp == bot->stamp && entry->key == child->hash) {
+                BeamNode *kept = &bot->children[entry->node];
+                bot->transpositions++;
+                if (child->score > kept->score) {
+                    kept->merged = true;
+                    entry->node = index;
+                } else {
+                    child->merged = true;
+                }
+            } else { // Empty, stale or another board: the newest board wins the slot
+                entry->key = child->hash;
+                entry->stamp = bot->stamp;
+                entry->node = index;
+            }
+        }
+    }
+
+    int count = 0;
+    for (int i = 0; i < bot->beam_count; ++i) {
+        for (int k = 0; k < bot->child_counts[i]; ++k) {
+            int index = i * MAX_PLACEMENTS + k;
+            if (bot->children[index].merged) continue;
+            bot->ranked[count].score = bot->children[index].score;
+            bot->ranked[count].index = index;
+            ++count;
+        }
+    }
+    if (count == 0) return 0;
+    qsort(bot->ranked, (size_t)count, sizeof(Ranked), compare_ranked);
+    if (count > bot->beam_shape.width) count = bot->beam_shape.width;
+    for (int i = 0; i < count; ++i) {
+        bot->beam[i] = bot->children[bot->ranked[i].index];
+    }
+    bot->beam_count = count;
+    return count;
+}
+
+// Inputs that take the falling piece to a placement
+static TetrisBotMove make_move(const Placement *p, double score) {
+    TetrisBotMove move = {0};
+    move.found = true;
+    move.x = p->x;
+    move.y = p->y;
+    move.rotation = p->rotation;
+    move.score = score;
+    for (int i = 0; i < abs(p->turns); ++i) {
+        move.actions[move.action_count++] = p->turns < 0 ? AltAction : Action;
+    }
+    for (int dx = p->x - p->kick_x; dx != 0; dx += dx < 0 ? 1 : -1) {
+        move.actions[move.action_count++] = dx < 0 ? Left : Right;
+    }
+    move.actions[move.action_count++] = Up;
+    return move;
+}
+
+// --- Bot API ---
+
+TetrisBot *tetris_bot_create(int threads) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    TetrisBot *bot = (TetrisBot *)calloc(1, sizeof(TetrisBot));
+    if (!bot) return NULL;
+    bot->weights = tetris_bot_default_weights;
+    bot->worker_slots = threads - 1;
+    if (bot->worker_slots > 0) {
+        bot->workers = (thrd_t *)calloc((size_t)bot->worker_slots, sizeof(thrd_t));
+    }
+    if ((bot->worker_slots > 0 && !bot->workers) || mtx_init(&bot->lock, mtx_plain) != thrd_success) {
+        free(bot->workers);
+        free(bot);
+        return NULL;
+    }
+    cnd_init(&bot->wake);
+    cnd_init(&bot->done);
+    atomic_init(&bot->cursor, 0);
+    atomic_init(&bot->evaluations, 0);
+    GameRandom_t rng;
+    seedGameRandom(&rng, ZOBRIST_SEED);
+    for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) {
+        for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
+            bot->zobrist[r][c] = (uint64_t)nextGameRandom(&rng) << 32 | nextGameRandom(&rng);
+        }
+    }
+    if (!tetris_bot_set_beam(bot, &tetris_bot_default_beam)) {
+        cnd_destroy(&bot->done);
+        cnd_destroy(&bot->wake);
+        mtx_destroy(&bot->lock);
+        free(bot->workers);
+        free(bot);
+        return NULL;
+    }
+    bot->thread_count = 1;
+    for (int i = 0; i < bot->worker_slots; ++i) {
+        if (thrd_create(&bot->workers[i], worker_main, bot) != thrd_success) break;
+        bot->thread_count++; // Run with the workers we got
+    }
+    return bot;
+}
+
+void tetris_bot_destroy(TetrisBot *bot) {
+    if (!bot) return;
+    mtx_lock(&bot->lock);
+    bot->stopping = true;
+    cnd_broadcast(&bot->wake);
+    mtx_unlock(&bot->lock);
+    for (int i = 0; i < bot->thread_count - 1; ++i) {
+        thrd_join(bot->workers[i], NULL);
+    }
+    cnd_destroy(&bot->done);
+    cnd_destroy(&bot->wake);
+    mtx_destroy(&bot->lock);
+    free(bot->beam);
+    free(bot->children);
+    free(bot->child_counts);
+    free(bot->ranked);
+    free(bot->table);
+    free(bot->workers);
+    free(bot);
+}
+
+int tetris_bot_threads(const TetrisBot *bot) {
+    return bot->thread_count;
+}
+
+void tetris_bot_set_weights(TetrisBot *bot, const TetrisBotWeights *weights) {
+    bot->weights = *weights;
+}
+
+unsigned long long tetris_bot_evaluations(const TetrisBot *bot) {
+    return atomic_load(&bot->evaluations);
+}
+
+unsigned long long tetris_bot_transpositions(const TetrisBot *bot) {
+    return bot->transpositions;
+}
+
+size_t tetris_bot_memory(const TetrisBot *bot) {
+    size_t width = (size_t)bot->beam_shape.width;
+    return sizeof(TetrisBot) + (size_t)bot->worker_slots * sizeof(thrd_t) +
+           width * sizeof(BeamNode) + width * MAX_PLACEMENTS * sizeof(BeamNode) +
+           width * sizeof(int) + width * MAX_PLACEMENTS * sizeof(Ranked) +
+           (sizeof(TableEntry) << bot->beam_shape.table_bits);
+}
+
+bool tetris_bot_set_beam(TetrisBot *bot, const TetrisBotBeam *beam) {
+    if (beam->width < 1 || beam->depth < 1 || beam->depth > TETRIS_BOT_MAX_DEPTH ||
+        beam->table_bits < 1 || beam->table_bits > MAX_TABLE_BITS) {
+        return false;
+    }
+    size_t width = (size_t)beam->width;
+    BeamNode *nodes = (BeamNode *)malloc(width * sizeof(BeamNode));
+    BeamNode *children = (BeamNode *)malloc(width * MAX_PLACEMENTS * sizeof(BeamNode));
+    int *child_counts = (int *)malloc(width * sizeof(int));
+    Ranked *ranked = (Ranked *)malloc(width * MAX_PLACEMENTS * sizeof(Ranked));
+    TableEntry *table = (TableEntry *)calloc((size_t)1 << beam->table_bits, sizeof(TableEntry));
+    if (!nodes || !children || !child_counts || !ranked || !table) {
+        free(nodes);
+        free(children);
+        free(child_counts);
+        free(ranked);
+        free(table);
+        return false;
+    }
+    free(bot->beam);
+    free(bot->children);
+    free(bot->child_counts);
+    free(bot->ranked);
+    free(bot->table);
+    bot->beam = nodes;
+    bot->children = children;
+    bot->child_counts = child_counts;
+    bot->ranked = ranked;
+    bot->table = table;
+    bot->stamp = 0;
+    bot->beam_shape = *beam;
+    return true;
+}
+
+TetrisBotMove tetris_bot_search(TetrisBot *bot, const TetrisContext *ctx, bool use_next) {
+    TetrisBotMove move = {0};
+    const CurrentPieceState *piece = &ctx->current_piece;
+    if (!piece->active) return move;
+
+    bot->board = &ctx->board;
+    bot->type = piece->type;
+    bot->next_type = use_next ? tetris_preview_piece(ctx, 0) : -1;
+    bot->count = enumerate_placements(&ctx->board, piece->type, piece->x, piece->y, piece->rotation,
+                                      bot->placements);
+    if (bot->count == 0) return move;
+    atomic_store(&bot->cursor, 0);
+    run_on_all_threads(bot, run_jobs);
+
+    int best = 0;
+    for (int i = 1; i < bot->count; ++i) {
+        if (bot->scores[i] > bot->scores[best]) best = i;
+    }
+    return make_move(&bot->placements[best], bot->scores[best]);
+}
+
+TetrisBotMove tetris_bot_plan(TetrisBot *bot, const TetrisContext *ctx, const int *queue,
+                              int queue_length) {
+    TetrisBotMove move = {0};
+    const CurrentPieceState *piece = &ctx->current_piece;
+    if (!piece->active) return move;
+    int preview[TETRIS_PREVIEW_LENGTH];
+    if (!queue) {
+        queue_length = tetris_preview(ctx, preview, TETRIS_PREVIEW_LENGTH);
+        queue = preview;
+    }
+    int pieces[TETRIS_BOT_MAX_DEPTH];
+    int depth = 0;
+    pieces[depth++] = piece->type;
+    while (depth < bot->beam_shape.depth && depth - 1 < queue_length) {
+        pieces[depth] = queue[depth - 1];
+        ++depth;
+    }
+
+    bot->root_count = enumerate_placements(&ctx->board, piece->type, piece->x, piece->y,
+                                           piece->rotation, bot->roots);
+    if (bot->root_count == 0) return move;
+    BeamNode *root = &bot->beam[0];
+    root->board = ctx->board;
+    root->hash = board_hash(bot, &ctx->board);
+    root->score = 0.0;
+    root->lines = 0;
+    root->root = -1;
+    root->merged = false;
+    bot->beam_count = 1;
+    bot->pieces = pieces;
+    for (bot->depth = 0; bot->depth < depth; ++bot->depth) {
+        atomic_store(&bot->cursor, 0);
+        run_on_all_threads(bot, expand_jobs);
+        if (select_beam(bot) == 0) break; // Every state topped out; plan with the last beam
+    }
+    bot->pieces = NULL;
+
+    const BeamNode *best = &bot->beam[0];
+    if (best->root < 0) return move;
+    return make_move(&bot->roots[best->root], best->score);
+}
@@ -0,0 +1,146 @@
+#ifndef S21_TETRIS_BOT_H
+#define S21_TETRIS_BOT_H
+
+#include "tetris.h"
+
+#ifdef __cplusplus
+namespace s21 {
+extern "C" {
+#endif
+
+// Deepest plan, in pieces, tetris_bot_plan() looks at
+#define TETRIS_BOT_MAX_DEPTH 8
+
+// Weights of the placement heuristic; the score of a resulting board is the
+// weighted sum of its metrics, higher is better
+typedef struct {
+    double aggregate_height;
+    double lines;            // Per line cleared by the placement
+    double holes;
+    double bumpiness;
+} TetrisBotWeights;
+
+// Weights tuned for single-piece play (aggregate height, lines, holes, bumpiness)
+extern const TetrisBotWeights tetris_bot_default_weights;
+
+// Shape of a multi-piece beam search
+typedef struct {
+    int width;       // States kept after every piece
+    int depth;       // Pieces planned ahead, the falling one included
+    int table_bits;  // The transposition table holds 2^table_bits entries
+} TetrisBotBeam;
+
+// A 64-wide beam three pieces deep over a 64K-entry (1 MiB) table
+extern const TetrisBotBeam tetris_bot_default_beam;
+
+// Best placement found by a search and the inputs that reach it
+typedef struct {
+    bool found;            // false if no piece is falling or nothing fits
+    int x;                 // Final column of the piece's 4x4 grid
+    int y;                 // Final row of the piece's 4x4 grid
+    int rotation;          // Final rotation index
+    double score;          // Heuristic score of the resulting board
+    int action_count;
+    UserAction_t actions[TETRIS_BOT_MAX_ACTIONS]; // Rotations, shifts, then Up (hard drop)
+} TetrisBotMove;
+
+/**
+ * @brief Creates a bot with its own pool of worker threads.
+ *
+ * The thread calling tetris_bot_search() takes part in every search, so a
+ * bot with one thread starts no workers at all.
+ *
+ * @param threads Threads to search with, or 0 for one per online CPU.
+ * @return TetrisBot* The new bot, or NULL if it could not be created.
+ */
+TetrisBot *tetris_bot_create(int threads);
+
+/**
+ * @brief Stops the workers and frees a bot.
+ *
+ * @param bot The bot to destroy (may be NULL).
+ */
+void tetris_bot_destroy(TetrisBot *bot);
+
+/**
+ * @brief Number of threads, including the caller, a search runs on.
+ */
+int tetris_bot_threads(const TetrisBot *bot);
+
+/**
+ * @brief Replaces the heuristic weights used by later searches.
+ */
+void tetris_bot_set_weights(TetrisBot *bot, const TetrisBotWeights *weights);
+
+/**
+ * @brief Total number of boards the bot has scored since it was created.
+ */
+unsigned long long tetris_bot_evaluations(const TetrisBot *bot);
+
+/**
+ * @brief Number of beam states merged into an equal board found earlier.
+ */
+unsigned long long tetris_bot_transpositions(const TetrisBot *bot);
+
+/**
+ * @brief Bytes of memory the bot owns, the beam buffers and table included.
+ */
+size_t tetris_bot_memory(const TetrisBot *bot);
+
+/**
+ * @brief Resizes the beam searched by tetris_bot_plan().
+ *
+ * The buffers are sized up front, so a plan never allocates and its memory
+ * stays bounded by tetris_bot_memory().
+ *
+ * @param bot The bot to configure.
+ * @param beam Width at least 1, depth at least 1 and table_bits in [1, 30].
+ * @return true on success; false leaves the previous beam in place.
+ */
+bool tetris_bot_set_beam(TetrisBot *bot, const TetrisBotBeam *beam);
+
+/**
+ * @brief Finds the best placement of the falling piece.
+ *
+ * Every rotation and column reachable from the piece's current position by
+ * rotating with wall kicks, shifting sideways and hard dropping is scored. With
+ * lookahead, each result is scored by the best follow-up placement of the
+ * next piece instead. The context is only read, and must not be modified
+ * until the search returns.
+ *
+ * @param bot The bot to search with.
+ * @param ctx The game to plan for.
+ * @param use_next true to look one piece ahead using the next piece.
+ * @return TetrisBotMove The best move; equal scores prefer the earlier
+ * placement, so results do not depend on the thread count.
+ */
+TetrisBotMove tetris_bot_search(TetrisBot *bot, const TetrisContext *ctx, bool use_next);
+
+/**
+ * @brief Plans several pieces ahead with a beam search.
+ *
+ * Starting from the falling piece, every state of the beam is expanded by
+ * all placements of the next queued piece, and the best `width` resulting
+ * boards are kept. Boards reached through different placement orders are
+ * recognised by their Zobrist hash and merged, keeping the better path.
+ * The search ends after `depth` pieces or when the queue runs out, and
+ * returns the first move of the best path. Expansion is spread over the
+ * bot's threads; the result does not depend on the thread count.
+ *
+ * @param bot The bot to plan with.
+ * @param ctx The game to plan for; only read.
+ * @param queue Piece types following the falling one, or NULL to use the
+ * context's preview.
+ * @param queue_length Number of entries in queue.
+ * @return TetrisBotMove The first move of the best plan; its score is the
+ * score of the plan's final board.
+ */
+TetrisBotMove tetris_bot_plan(TetrisBot *bot, const TetrisContext *ctx, const int *queue,
+                              int queue_length);
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace s21
+#endif
+
+#endif // S21_TETRIS_BOT_H
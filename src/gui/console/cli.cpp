@@ -1,123 +1,259 @@
 #include "cli.h"
 
+#include <poll.h>    // For waiting on keys and ticks at once
+#include <unistd.h>  // For STDIN_FILENO
+
+#include <algorithm>  // For std::min
+#include <chrono>     // For the step clock and tick deadlines
+#include <cstdio>     // For the jitter report
+#include <cstring>    // For std::strcmp
+
+#include "../../brick_game/GameRunner.h"
+
 // --- ncurses Renderer ---
 
-void draw_game(const game::GameInfo_t& game_info) {
-  clear();  // Clear the ncurses screen
+namespace {
 
-  // Define offsets for the game field, if you want it centered or padded
-  int start_row = 2;
-  int start_col = 2;
+// Layout of the screen
+constexpr int kStartRow = 2;  // Top of the game field
+constexpr int kStartCol = 2;  // Left of the game field
+// Sidebar info - position it to the right of the game field
+constexpr int kSidebarCol =
+    kStartCol + game::FIELD_WIDTH * 2 + 3;  // 3 spaces for margin
+constexpr int kNextRow = kStartRow + 11;    // Top of the next piece field
+constexpr int kPreviewRow = kStartRow + 16;
 
-  // Sidebar info - position it to the right of the game field
-  int sidebar_col =
-      start_col + game::FIELD_WIDTH * 2 + 3;  // 3 spaces for margin
+// What the terminal shows at the moment, so a frame only rewrites the cells
+// and sidebar fields that changed since the previous one
+struct DrawnScreen {
+  bool valid = false;  // false forces a full redraw
+  int field[game::FIELD_HEIGHT][game::FIELD_WIDTH];
+  int next[game::NEXT_FIELD_HEIGHT][game::NEXT_FIELD_WIDTH];
+  int landing_row;
+  int score;
+  int high_score;
+  int level;
+  int speed;
+  game::GameState state;
+  int preview[game::PREVIEW_LENGTH];
+  int preview_count;
+};
 
-  // Draw top border
-  mvprintw(start_row - 1, start_col - 1, "+");
-  for (int i = 0; i < game::FIELD_WIDTH; ++i) {
-    mvprintw(start_row - 1, start_col + i * 2, "--");
+DrawnScreen drawn;
+
+// Each game "pixel" is 2 chars wide
+const char* cell_text(int cell) {
+  switch (cell) {
+    case game::EMPTY:
+      return "  ";
+    case game::HEAD:
+      return "@@";
+    case game::BODY:
+      return "[]";
+    case game::FOOD:
+      return "()";
+    case game::GHOST:
+      return "::";
+    default:
+      return "??";
   }
-  mvprintw(start_row - 1, start_col + game::FIELD_WIDTH * 2, "+");
+}
+
+// Rewrites one sidebar line, clearing what the previous value left behind
+void draw_sidebar_line(int row, const char* text) {
+  move(row, kSidebarCol);
+  clrtoeol();
+  addstr(text);
+}
 
-  // Draw game field and sidebar
+void draw_borders() {
+  const int bottom_row = kStartRow + game::FIELD_HEIGHT;
+  for (int row : {kStartRow - 1, bottom_row}) {
+    mvaddstr(row, kStartCol - 1, "+");
+    for (int i = 0; i < game::FIELD_WIDTH; ++i) {
+      mvaddstr(row, kStartCol + i * 2, "--");
+    }
+    mvaddstr(row, kStartCol + game::FIELD_WIDTH * 2, "+");
+  }
   for (int y = 0; y < game::FIELD_HEIGHT; ++y) {
-    // Left border
-    mvprintw(start_row + y, start_col - 1, "|");
+    mvaddstr(kStartRow + y, kStartCol - 1, "|");
+    mvaddstr(kStartRow + y, kStartCol + game::FIELD_WIDTH * 2, "|");
+  }
+  mvaddstr(kStartRow + 9, kSidebarCol, "Press 'Q' to Quit");
+}
+
+// Side borders of a field row, with arrows on the row the falling piece
+// lands on
+void draw_landing_marks(int row, bool landing) {
+  if (row < 0 || row >= game::FIELD_HEIGHT) return;
+  mvaddstr(kStartRow + row, kStartCol - 1, landing ? ">" : "|");
+  mvaddstr(kStartRow + row, kStartCol + game::FIELD_WIDTH * 2,
+           landing ? "<" : "|");
+}
+
+void draw_state_lines(game::GameState state) {
+  const char* status = "";
+  if (state == game::PAUSED)
+    status = "--- PAUSED ---";
+  else if (state == game::START_SCREEN)
+    status = "Press 'S' to Start";
+  else if (state == game::GAME_OVER_WIN)
+    status = "YOU WIN!";
+  else if (state == game::GAME_OVER_LOSE)
+    status = "GAME OVER!";
+  draw_sidebar_line(kStartRow + 5, status);
+
+  const char* hint = "";
+  if (state == game::PAUSED)
+    hint = "Press 'P' to Resume";
+  else if (state == game::GAME_OVER_WIN || state == game::GAME_OVER_LOSE)
+    hint = "Press 'S' to Restart";
+  draw_sidebar_line(kStartRow + 6, hint);
+}
+
+// Rewrites a numeric sidebar field if its value changed
+void draw_number(int row, const char* format, int value, int* shown,
+                 bool full) {
+  if (!full && value == *shown) return;
+  move(row, kSidebarCol);
+  clrtoeol();
+  printw(format, value);
+  *shown = value;
+}
+
+}  // namespace
+
+void invalidate_screen() { drawn.valid = false; }
+
+void draw_game(const game::GameInfo_t& game_info, int landing_row,
+               const int* preview, int preview_count) {
+  const bool full = !drawn.valid;
+  if (full) {
+    erase();  // Blank the window once; later frames only patch it
+    draw_borders();
+  }
+
+  if (full || landing_row != drawn.landing_row) {
+    if (!full) draw_landing_marks(drawn.landing_row, false);
+    draw_landing_marks(landing_row, true);
+    drawn.landing_row = landing_row;
+  }
 
+  for (int y = 0; y < game::FIELD_HEIGHT; ++y) {
     for (int x = 0; x < game::FIELD_WIDTH; ++x) {
-      int screen_x = start_col + x * 2;  // Each game "pixel" is 2 chars wide
-      int screen_y = start_row + y;
-      switch (game_info.field[y][x]) {
-        case game::EMPTY:
-          mvprintw(screen_y, screen_x, "  ");
-          break;
-        case game::HEAD:
-          mvprintw(screen_y, screen_x, "@@");
-          break;
-        case game::BODY:
-          mvprintw(screen_y, screen_x, "[]");
-          break;
-        case game::FOOD:
-          mvprintw(screen_y, screen_x, "()");
-          break;
-        default:
-          mvprintw(screen_y, screen_x, "??");
-          break;
-      }
+      const int cell = game_info.field[y][x];
+      if (!full && cell == drawn.field[y][x]) continue;
+      mvaddstr(kStartRow + y, kStartCol + x * 2, cell_text(cell));
+      drawn.field[y][x] = cell;
     }
-    // Right border
-    mvprintw(start_row + y, start_col + game::FIELD_WIDTH * 2, "|");
-
-    if (y == 0)
-      mvprintw(start_row + y, sidebar_col, "Score: %d", game_info.score);
-    else if (y == 1)
-      mvprintw(start_row + y, sidebar_col, "High Score: %d",
-               game_info.high_score);
-    else if (y == 2)
-      mvprintw(start_row + y, sidebar_col, "Level: %d", game_info.level);
-    else if (y == 3)
-      mvprintw(start_row + y, sidebar_col, "Speed: %dms", game_info.speed);
-    else if (y == 5) {
-      if (game_info.current_game_state == game::PAUSED)
-        mvprintw(start_row + y, sidebar_col, "--- PAUSED ---");
-      else if (game_info.current_game_state == game::START_SCREEN)
-        mvprintw(start_row + y, sidebar_col, "Press 'S' to Start");
-      else if (game_info.current_game_state == game::GAME_OVER_WIN)
-        mvprintw(start_row + y, sidebar_col, "YOU WIN!");
-      else if (game_info.current_game_state == game::GAME_OVER_LOSE)
-        mvprintw(start_row + y, sidebar_col, "GAME OVER!");
-    } else if (y == 6) {
-      if (game_info.current_game_state == game::PAUSED)
-        mvprintw(start_row + y, sidebar_col, "Press 'P' to Resume");
-      else if (game_info.current_game_state == game::GAME_OVER_WIN ||
-               game_info.current_game_state == game::GAME_OVER_LOSE)
-        mvprintw(start_row + y, sidebar_col, "Press 'S' to Restart");
-    } else if (y == 9)
-      mvprintw(start_row + y, sidebar_col, "Press 'Q' to Quit");
   }
 
-  for (int next_field_y = 0; next_field_y < game::NEXT_FIELD_HEIGHT;
-       ++next_field_y) {
-    for (int next_field_x = 0; next_field_x < game::NEXT_FIELD_WIDTH;
-         ++next_field_x) {
-      int screen_x = sidebar_col + 1 +
-                     next_field_x * 2;  // Each game "pixel" is 2 chars wide
-      int screen_y = start_row + next_field_y + 11;
-      switch (game_info.next[next_field_y][next_field_x]) {
-        case game::EMPTY:
-          mvprintw(screen_y, screen_x, "  ");
-          break;
-        case game::HEAD:
-          mvprintw(screen_y, screen_x, "@@");
-          break;
-        case game::BODY:
-          mvprintw(screen_y, screen_x, "[]");
-          break;
-        case game::FOOD:
-          mvprintw(screen_y, screen_x, "()");
-          break;
-        default:
-          mvprintw(screen_y, screen_x, "??");
-          break;
-      }
+  draw_number(kStartRow, "Score: %d", game_info.score, &drawn.score, full);
+  draw_number(kStartRow + 1, "High Score: %d", game_info.high_score,
+              &drawn.high_score, full);
+  draw_number(kStartRow + 2, "Level: %d", game_info.level, &drawn.level,
+              full);
+  draw_number(kStartRow + 3, "Speed: %dms", game_info.speed, &drawn.speed,
+              full);
+  if (full || game_info.current_game_state != drawn.state) {
+    draw_state_lines(game_info.current_game_state);
+    drawn.state = game_info.current_game_state;
+  }
+
+  for (int y = 0; y < game::NEXT_FIELD_HEIGHT; ++y) {
+    for (int x = 0; x < game::NEXT_FIELD_WIDTH; ++x) {
+      const int cell = game_info.next[y][x];
+      if (!full && cell == drawn.next[y][x]) continue;
+      mvaddstr(kNextRow + y, kSidebarCol + 1 + x * 2, cell_text(cell));
+      drawn.next[y][x] = cell;
     }
   }
 
-  // Draw bottom border
-  int bottom_row = start_row + game::FIELD_HEIGHT;
-  mvprintw(bottom_row, start_col - 1, "+");
-  for (int i = 0; i < game::FIELD_WIDTH; ++i) {
-    mvprintw(bottom_row, start_col + i * 2, "--");
+  // Pieces queued after the next one, by tetromino letter
+  static const char kPieceNames[] = "IJLOSTZ";
+  preview_count = std::min<int>(preview_count, game::PREVIEW_LENGTH);
+  bool preview_changed = full || preview_count != drawn.preview_count;
+  for (int i = 0; i < preview_count && !preview_changed; ++i) {
+    preview_changed = preview[i] != drawn.preview[i];
+  }
+  if (preview_changed) {
+    draw_sidebar_line(kPreviewRow, preview_count > 1 ? "Then:" : "");
+    for (int i = 0; i < preview_count; ++i) {
+      if (i > 0) {
+        mvaddch(kPreviewRow, kSidebarCol + 4 + i * 2, kPieceNames[preview[i]]);
+      }
+      drawn.preview[i] = preview[i];
+    }
+    drawn.preview_count = preview_count;
   }
-  mvprintw(bottom_row, start_col + game::FIELD_WIDTH * 2, "+");
 
-  refresh();  // Update the physical screen
+  drawn.valid = true;
+  refresh();  // One flush for everything that changed
+}
+
+// --- Input ---
+
+// Maps a key to its game action; false for keys the games do not use
+static bool key_action(int key, game::UserAction_t* action) {
+  switch (key) {
+    case 'w':
+    case 'W':
+    case KEY_UP:  // ncurses constant for Up Arrow
+      *action = game::Up;
+      return true;
+    case 'a':
+    case 'A':
+    case KEY_LEFT:  // ncurses constant for Left Arrow
+      *action = game::Left;
+      return true;
+    case 's':
+    case 'S':
+      *action = game::Start;
+      return true;
+    case 'd':
+    case 'D':
+    case KEY_RIGHT:  // ncurses constant for Right Arrow
+      *action = game::Right;
+      return true;
+    case KEY_DOWN:  // ncurses constant for Down Arrow ('S' starts the game)
+      *action = game::Down;
+      return true;
+    case 'p':
+    case 'P':
+      *action = game::Pause;
+      return true;
+    case 'z':
+    case 'Z':
+      *action = game::AltAction;  // Counter-clockwise rotation
+      return true;
+    case 'b':
+    case 'B':
+      *action = game::Autopilot;  // Tetris bot on/off
+      return true;
+    case ' ':                  // Space bar
+      *action = game::Action;  // Rotates in Tetris, speeds Snake up
+      return true;
+    case 'q':
+    case 'Q':
+      *action = game::Terminate;
+      return true;
+    default:
+      return false;  // Includes KEY_RESIZE, which only needs a redraw
+  }
 }
 
 // --- Main Game Loop ---
 
-int main() {
+int main(int argc, char* argv[]) {
+  using Clock = std::chrono::steady_clock;
+
+  // --threaded steps the game on its own thread, away from the terminal I/O
+  const bool threaded = argc > 1 && std::strcmp(argv[1], "--threaded") == 0;
+  s21_controller::GameRunner runner;
+  if (threaded) runner.start();
+  // A key sent to the runner shows after its next tick; repaint this soon
+  const auto runner_settle = std::chrono::milliseconds(20);
+
   // Initialize ncurses
   initscr();              // Start ncurses mode
   cbreak();               // Line buffering disabled, Pass on evertyhing
@@ -126,78 +262,90 @@ int main() {
   nodelay(stdscr, TRUE);  // getch() will be non-blocking
   curs_set(0);            // Make cursor invisible
 
-  game::GameInfo_t game_info;
-
   bool running = true;
+  bool idle = false;  // Nothing changes until a key arrives
+  s21_controller::StepClock step_clock;  // Waiting for a key is not game time
+  Clock::time_point next_tick = Clock::now();
 
   while (running) {
-    // 1. Process Input
-    int input_key = getch();  // Read key press (non-blocking)
-    flushinp();
-    game::UserAction_t action = game::Action;  // Default action
-
-    if (input_key != ERR) {  // ERR means no key was pressed
-      switch (input_key) {
-        case 'w':
-        case 'W':
-        case KEY_UP:  // ncurses constant for Up Arrow
-          action = game::Up;
-          break;
-        case 'a':
-        case 'A':
-        case KEY_LEFT:  // ncurses constant for Left Arrow
-          action = game::Left;
-          break;
-        case 's':
-        case 'S':
-          action = game::Start;
-          break;
-        case 'd':
-        case 'D':
-        case KEY_RIGHT:  // ncurses constant for Right Arrow
-          action = game::Right;
-          break;
-        // Adding explicit Down action if needed, e.g. with KEY_DOWN
-        case KEY_DOWN:  // ncurses constant for Down Arrow
-                        // (Original code used 'S' for start, not explicitly for
-                        // moving down)
-          action = game::Down;
-          break;
-        case 'p':
-        case 'P':
-          action = game::Pause;
-          break;
-        case ' ':                 // Space bar
-          action = game::Action;  // Assuming this is for "speed up" or
-                                  // generic action
-          break;
-        case 'q':
-        case 'Q':
-          action = game::Terminate;
-          break;
-        default:
-          // Optional: handle other keys or ignore
-          break;
+    // 1. Sleep until a key arrives or the next tick is due; an idle game
+    // (start screen, pause, game over) blocks until a key arrives
+    int timeout_ms = -1;
+    if (!idle) {
+      const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+          next_tick - Clock::now());
+      timeout_ms = wait.count() > 0 ? static_cast<int>(wait.count()) : 0;
+    }
+    pollfd terminal = {STDIN_FILENO, POLLIN, 0};
+    poll(&terminal, 1, timeout_ms);  // Interrupted by a signal: just redraw
+
+    // 2. Process Input: every key that is waiting, right away
+    bool had_input = false;
+    int input_key;
+    while ((input_key = getch()) != ERR) {  // ERR means no key is left
+      if (input_key == KEY_RESIZE) invalidate_screen();
+      game::UserAction_t action;
+      if (!key_action(input_key, &action)) continue;
+      had_input = true;
+      // Terminals report no key releases, so every key is a single tap
+      if (threaded) {
+        runner.userInput(action, false);
+        runner.releaseInput(action);
+      } else {
+        s21_controller::userInput(action, false);  // Pass action to game model
+        s21_controller::releaseInput(action);
       }
-      s21_controller::userInput(action, false);  // Pass action to game model
     }
 
-    // 2. Update Game State & Get Info for Rendering
-    game_info = s21_controller::updateCurrentState();
+    // 3. Step the game by the time that really passed, then borrow a frame;
+    // the runner has done both on its own thread
+    const Clock::time_point now = Clock::now();
+    const game::GameFrame_t* frame = nullptr;
+    if (threaded) {
+      frame = runner.latest();
+    } else {
+      s21_controller::step(step_clock.lap(now));
+      frame = s21_controller::snapshot();
+    }
+    if (frame == nullptr) break;  // Only happens if frames are leaked
+    const game::GameInfo_t& game_info = frame->info;
 
-    // 3. Render
-    draw_game(game_info);
+    // 4. Render
+    draw_game(game_info, frame->landing_row, frame->preview,
+              frame->preview_count);
 
-    // 4. Check for game termination
+    // 5. Check for game termination and schedule the next tick
     if (game_info.current_game_state == game::TERMINATE_GAME) {
       running = false;
     }
-    // 5. Control Game Speed
-    std::this_thread::sleep_for(std::chrono::milliseconds(game_info.speed));
+    idle = game_info.current_game_state != game::GAME_RUNNING ||
+           game_info.pause;
+    if (idle) step_clock.stop();  // The key that ends the wait starts at 0
+    if (now >= next_tick) {
+      next_tick = now + std::chrono::milliseconds(game_info.speed);
+    }
+    if (threaded && had_input) {
+      idle = false;
+      next_tick = std::min(next_tick, now + runner_settle);
+    }
+    if (!threaded) s21_controller::releaseCurrentState(frame);
   }
 
   // Cleanup ncurses
   endwin();  // Restore terminal settings
 
+  if (threaded) {
+    runner.stop();
+    const s21_controller::JitterReport jitter = runner.jitterReport();
+    const s21_controller::JitterReport input = runner.inputLatencyReport();
+    std::printf(
+        "%llu ticks, lateness p50 %.0f us, p99 %.0f us, max %.0f us\n",
+        static_cast<unsigned long long>(jitter.ticks), jitter.p50_us,
+        jitter.p99_us, jitter.max_us);
+    std::printf("%llu inputs, input to tick p50 %.0f us, p99 %.0f us\n",
+                static_cast<unsigned long long>(input.ticks), input.p50_us,
+                input.p99_us);
+  }
+
   return 0;
 }
@@ -3,10 +3,6 @@
 
 #include <ncurses.h>  // For ncurses functions
 
-#include <chrono>  // For std::chrono::milliseconds
-#include <string>  // For std::to_string
-#include <thread>  // For std::this_thread::sleep_for
-
 // Assuming GameController.h defines the s21 namespace, GameInfo_t, constants,
 // etc.
 #include "../../brick_game/GameController.h"
@@ -14,7 +10,15 @@
 // Namespace alias for convenience
 namespace game = s21;
 
-// Draws the current game state to the ncurses console.
-void draw_game(const game::GameInfo_t& game_info);
+// Draws the current game state to the ncurses console. landing_row marks
+// where the falling piece would land (-1 for none); the pieces after the one
+// in the next field are listed from preview[1] on. Only the cells and
+// sidebar fields that differ from the previous call are rewritten, and the
+// terminal is flushed once.
+void draw_game(const game::GameInfo_t& game_info, int landing_row = -1,
+               const int* preview = nullptr, int preview_count = 0);
+
+// Makes the next draw_game() repaint the whole screen, e.g. after a resize
+void invalidate_screen();
 
 #endif  // S21_BRICKGAME_CLI_H
\ No newline at end of file
@@ -3,16 +3,19 @@
 const int GUI_MAIN_BOARD_BLOCK_SIZE = 25;
 const int GUI_PREVIEW_BLOCK_SIZE = 20;
 const int GUI_PREVIEW_GRID_DIMENSION = 4;
+const int GUI_FRAME_INTERVAL_MS = 16;
 
 // GameBoardWidget Implementation
 GameBoardWidget::GameBoardWidget(QWidget *parent)
-    : QWidget(parent), current_game_data_ptr(nullptr) {
+    : QWidget(parent), current_game_data_ptr(nullptr), landing_row(-1) {
   setFixedSize(s21::FIELD_WIDTH * GUI_MAIN_BOARD_BLOCK_SIZE + 2,
                s21::FIELD_HEIGHT * GUI_MAIN_BOARD_BLOCK_SIZE + 2);
 }
 
-void GameBoardWidget::updateBoardDisplay(const s21::GameInfo_t *game_info) {
+void GameBoardWidget::updateBoardDisplay(const s21::GameInfo_t *game_info,
+                                         int landing_row) {
   current_game_data_ptr = game_info;
+  this->landing_row = landing_row;
   update();
 }
 
@@ -51,6 +54,9 @@ void GameBoardWidget::paintEvent(QPaintEvent *event) {
         case s21::FOOD:
           blockColor = Qt::red;
           break;
+        case s21::GHOST:
+          blockColor = QColor(70, 70, 70);
+          break;
         default:
           blockColor = Qt::darkMagenta;
           blockText = "?";
@@ -67,6 +73,12 @@ void GameBoardWidget::paintEvent(QPaintEvent *event) {
       }
     }
   }
+  if (landing_row >= 0) {
+    // Underline the row the falling piece will land on
+    int y = (landing_row + 1) * GUI_MAIN_BOARD_BLOCK_SIZE;
+    painter.setPen(QPen(QColor(120, 120, 120), 2));
+    painter.drawLine(1, y, width() - 2, y);
+  }
 }
 
 // GamePreviewWidget Implementation
@@ -127,7 +139,12 @@ void GamePreviewWidget::paintEvent(QPaintEvent *event) {
 }
 
 // GameMainWindow Implementation
-GameMainWindow::GameMainWindow(QWidget *parent) : QMainWindow(parent) {
+GameMainWindow::GameMainWindow(QWidget *parent, bool threaded)
+    : QMainWindow(parent), current_frame(nullptr) {
+  if (threaded) {
+    runner = std::make_unique<s21_controller::GameRunner>();
+    runner->start();
+  }
   setWindowTitle("Qt Generic Game GUI");
   current_game_info_struct.field = nullptr;
   current_game_info_struct.next = nullptr;
@@ -136,19 +153,45 @@ GameMainWindow::GameMainWindow(QWidget *parent) : QMainWindow(parent) {
   setupUI();
   gameLoopTimer = new QTimer(this);
   connect(gameLoopTimer, &QTimer::timeout, this, &GameMainWindow::onGameTick);
-  current_game_info_struct = s21_controller::updateCurrentState();
-  refreshUIDisplay();
-  updateTimerBasedOnGameState();
+  presentFrame();
   setFocusPolicy(Qt::StrongFocus);
   setFocus();
 }
 
-GameMainWindow::~GameMainWindow() { cleanupAllocatedGameInfoData(); }
+GameMainWindow::~GameMainWindow() {
+  releaseGameFrame();
+  if (runner) {
+    runner->stop();
+    const s21_controller::JitterReport jitter = runner->jitterReport();
+    const s21_controller::JitterReport input = runner->inputLatencyReport();
+    qInfo("%llu ticks, lateness p50 %.0f us, p99 %.0f us, max %.0f us",
+          static_cast<unsigned long long>(jitter.ticks), jitter.p50_us,
+          jitter.p99_us, jitter.max_us);
+    qInfo("%llu inputs, input to tick p50 %.0f us, p99 %.0f us",
+          static_cast<unsigned long long>(input.ticks), input.p50_us,
+          input.p99_us);
+  }
+}
+
+void GameMainWindow::sendInput(s21::UserAction_t action, bool hold) {
+  if (runner) {
+    runner->userInput(action, hold);
+  } else {
+    s21_controller::userInput(action, hold);
+  }
+}
+
+void GameMainWindow::sendRelease(s21::UserAction_t action) {
+  if (runner) {
+    runner->releaseInput(action);
+  } else {
+    s21_controller::releaseInput(action);
+  }
+}
 
 void GameMainWindow::keyPressEvent(QKeyEvent *event) {
   s21::UserAction_t action_to_send = s21::Action;
   bool relevant_key = true;
-  bool pause_key = false;
   switch (event->key()) {
     case Qt::Key_A:
     case Qt::Key_Left:
@@ -177,9 +220,14 @@ void GameMainWindow::keyPressEvent(QKeyEvent *event) {
     case Qt::Key_Space:
       action_to_send = s21::Action;
       break;
+    case Qt::Key_Z:
+      action_to_send = s21::AltAction;  // Counter-clockwise rotation
+      break;
+    case Qt::Key_B:
+      action_to_send = s21::Autopilot;  // Tetris bot on/off
+      break;
     case Qt::Key_P:
       action_to_send = s21::Pause;
-      pause_key = true;
       break;
     case Qt::Key_Q:
     case Qt::Key_Escape:
@@ -191,19 +239,46 @@ void GameMainWindow::keyPressEvent(QKeyEvent *event) {
       break;
   }
   if (relevant_key) {
-    s21_controller::userInput(action_to_send, event->isAutoRepeat());
-    if (pause_key || action_to_send == s21::Start ||
-        action_to_send == s21::Terminate) {
-      // Only update the pause UI instantly, not the whole game state
-      GameMainWindow::onGameTick();
-    }
-    // Do NOT update game state or UI for other keys here!
+    sendInput(action_to_send, event->isAutoRepeat());
+    presentFrame();  // Shows the key's effect now; does not advance the game
+  }
+}
+
+void GameMainWindow::keyReleaseEvent(QKeyEvent *event) {
+  if (event->isAutoRepeat()) return;  // Still held; the engine times repeats
+  switch (event->key()) {
+    case Qt::Key_A:
+    case Qt::Key_Left:
+      sendRelease(s21::Left);
+      break;
+    case Qt::Key_D:
+    case Qt::Key_Right:
+      sendRelease(s21::Right);
+      break;
+    case Qt::Key_S:
+    case Qt::Key_Down:
+      sendRelease(s21::Down);
+      break;
+    case Qt::Key_Space:
+      sendRelease(s21::Action);  // Ends a held Snake boost
+      break;
+    default:
+      QMainWindow::keyReleaseEvent(event);
+      break;
   }
 }
 
 void GameMainWindow::onGameTick() {
-  cleanupAllocatedGameInfoData();
-  current_game_info_struct = s21_controller::updateCurrentState();
+  // The game advances by the time that really passed, so the timer only
+  // decides how often the window repaints
+  const double seconds = tickClock.nsecsElapsed() / 1e9;
+  tickClock.restart();
+  if (!runner) s21_controller::step(seconds);  // The runner steps itself
+  presentFrame();
+}
+
+void GameMainWindow::presentFrame() {
+  fetchGameFrame();
   refreshUIDisplay();
   updateTimerBasedOnGameState();
 }
@@ -241,27 +316,28 @@ void GameMainWindow::setupUI() {
   adjustSize();
 }
 
-void GameMainWindow::cleanupAllocatedGameInfoData() {
-  if (current_game_info_struct.field) {
-    for (int i = 0; i < s21::FIELD_HEIGHT; ++i) {
-      if (current_game_info_struct.field[i])
-        free(current_game_info_struct.field[i]);
-    }
-    free(current_game_info_struct.field);
-    current_game_info_struct.field = nullptr;
-  }
-  if (current_game_info_struct.next) {
-    for (int i = 0; i < GUI_PREVIEW_GRID_DIMENSION; ++i) {
-      if (current_game_info_struct.next[i])
-        free(current_game_info_struct.next[i]);
-    }
-    free(current_game_info_struct.next);
-    current_game_info_struct.next = nullptr;
+void GameMainWindow::fetchGameFrame() {
+  // The engine double-buffers its frames, so the new one never aliases the
+  // frame the widgets are still pointing at until it is released below.
+  const s21::GameFrame_t *next_frame =
+      runner ? runner->latest() : s21_controller::snapshot();
+  if (!next_frame) return;
+  releaseGameFrame();
+  current_frame = next_frame;
+  current_game_info_struct = current_frame->info;
+}
+
+void GameMainWindow::releaseGameFrame() {
+  if (current_frame && !runner) {  // Runner frames are never borrowed
+    s21_controller::releaseCurrentState(current_frame);
   }
+  current_frame = nullptr;
 }
 
 void GameMainWindow::refreshUIDisplay() {
-  mainGameBoardWidget->updateBoardDisplay(&current_game_info_struct);
+  mainGameBoardWidget->updateBoardDisplay(
+      &current_game_info_struct,
+      current_frame ? current_frame->landing_row : -1);
   itemPreviewWidget->updatePreviewDisplay(&current_game_info_struct);
   scoreDisplayLabel->setText(
       QString("Score: %1").arg(current_game_info_struct.score));
@@ -293,15 +369,14 @@ void GameMainWindow::refreshUIDisplay() {
 }
 
 void GameMainWindow::updateTimerBasedOnGameState() {
-  if (current_game_info_struct.current_game_state == s21::GAME_RUNNING &&
-      !current_game_info_struct.pause) {
-    if (current_game_info_struct.speed > 0) {
-      if (!gameLoopTimer->isActive() ||
-          gameLoopTimer->interval() != current_game_info_struct.speed) {
-        gameLoopTimer->start(current_game_info_struct.speed);
-      }
-    } else {
-      gameLoopTimer->stop();
+  // A runner applies input on its own ticks, so its frames are polled even
+  // while the game is idle
+  if (runner || (current_game_info_struct.current_game_state ==
+                     s21::GAME_RUNNING &&
+                 !current_game_info_struct.pause)) {
+    if (!gameLoopTimer->isActive()) {
+      tickClock.start();  // Time spent stopped is not game time
+      gameLoopTimer->start(GUI_FRAME_INTERVAL_MS);
     }
   } else {
     gameLoopTimer->stop();
@@ -313,7 +388,8 @@ void GameMainWindow::updateTimerBasedOnGameState() {
 
 int main(int argc, char *argv[]) {
   QApplication app(argc, argv);
-  GameMainWindow mainWindow;
+  GameMainWindow mainWindow(nullptr,
+                            app.arguments().contains("--threaded"));
   mainWindow.show();
   return app.exec();
 }
\ No newline at end of file
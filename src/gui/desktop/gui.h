@@ -2,6 +2,7 @@
 #define GUI_H
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QHBoxLayout>
 #include <QKeyEvent>
 #include <QLabel>
@@ -10,12 +11,15 @@
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
+#include <memory>
 
 #include "../../brick_game/GameController.h"
+#include "../../brick_game/GameRunner.h"
 
 extern const int GUI_MAIN_BOARD_BLOCK_SIZE;
 extern const int GUI_PREVIEW_BLOCK_SIZE;
 extern const int GUI_PREVIEW_GRID_DIMENSION;
+extern const int GUI_FRAME_INTERVAL_MS;
 
 /**
  * @brief Widget for displaying the main game board.
@@ -32,8 +36,10 @@ class GameBoardWidget : public QWidget {
   /**
    * @brief Updates the board display with new game info.
    * @param game_info Pointer to the current game info struct.
+   * @param landing_row Row the falling piece would land on, -1 for none.
    */
-  void updateBoardDisplay(const s21::GameInfo_t *game_info);
+  void updateBoardDisplay(const s21::GameInfo_t *game_info,
+                          int landing_row = -1);
 
  protected:
   /**
@@ -45,6 +51,7 @@ class GameBoardWidget : public QWidget {
  private:
   const s21::GameInfo_t
       *current_game_data_ptr;  ///< Pointer to current game data.
+  int landing_row;             ///< Row marked as the landing row, or -1.
 };
 
 /**
@@ -85,11 +92,14 @@ class GameMainWindow : public QMainWindow {
   /**
    * @brief Constructs the main window.
    * @param parent Parent widget.
+   * @param threaded Step the game on a GameRunner thread instead of the
+   * window's timer.
    */
-  explicit GameMainWindow(QWidget *parent = nullptr);
+  explicit GameMainWindow(QWidget *parent = nullptr, bool threaded = false);
 
   /**
-   * @brief Destructor for cleanup.
+   * @brief Destructor for cleanup; prints the runner's tick and input
+   * latency reports.
    */
   ~GameMainWindow();
 
@@ -100,9 +110,16 @@ class GameMainWindow : public QMainWindow {
    */
   void keyPressEvent(QKeyEvent *event) override;
 
+  /**
+   * @brief Ends the auto-repeat of a released movement key.
+   * @param event Key event.
+   */
+  void keyReleaseEvent(QKeyEvent *event) override;
+
  private slots:
   /**
-   * @brief Slot called on each game tick (timer event).
+   * @brief Slot called on each game tick (timer event): steps the game by
+   * the elapsed time and repaints.
    */
   void onGameTick();
 
@@ -116,7 +133,22 @@ class GameMainWindow : public QMainWindow {
   QLabel
       *gameStatusDisplayLabel;  ///< Displays game status (paused, over, etc).
   QTimer *gameLoopTimer;        ///< Timer for game loop.
+  QElapsedTimer tickClock;      ///< Time since the previous game step.
   s21::GameInfo_t current_game_info_struct;  ///< Holds current game info.
+  const s21::GameFrame_t
+      *current_frame;  ///< Borrowed engine frame backing the info struct.
+  std::unique_ptr<s21_controller::GameRunner>
+      runner;  ///< Steps the game when threaded, else nullptr.
+
+  /**
+   * @brief Sends a key press to the game, through the runner if there is one.
+   */
+  void sendInput(s21::UserAction_t action, bool hold);
+
+  /**
+   * @brief Sends a key release to the game, through the runner if any.
+   */
+  void sendRelease(s21::UserAction_t action);
 
   /**
    * @brief Sets up the user interface components.
@@ -124,9 +156,19 @@ class GameMainWindow : public QMainWindow {
   void setupUI();
 
   /**
-   * @brief Cleans up any allocated memory for game info data.
+   * @brief Repaints from a fresh snapshot without advancing the game.
+   */
+  void presentFrame();
+
+  /**
+   * @brief Borrows the next engine frame and releases the previous one.
+   */
+  void fetchGameFrame();
+
+  /**
+   * @brief Hands the currently borrowed frame back to the engine.
    */
-  void cleanupAllocatedGameInfoData();
+  void releaseGameFrame();
 
   /**
    * @brief Refreshes the UI display with the latest game info.
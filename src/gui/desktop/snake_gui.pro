@@ -9,7 +9,8 @@ TEMPLATE = app
 SOURCES += gui.cpp
 HEADERS += gui.h
 
-SOURCES += ../../brick_game/snake/snake.cpp ../../brick_game/GameController.cpp
+SOURCES += ../../brick_game/snake/snake.cpp ../../brick_game/GameController.cpp ../../brick_game/GameRunner.cpp
+LIBS += -pthread
 
 # Assuming game_controller.h and GameCommon.h are in a directory
 INCLUDEPATH += ../../brick_game ../../brick_game/snake # Or wherever your headers are
\ No newline at end of file
@@ -1,7 +1,7 @@
 # tetris_gui.pro
 
 QT       += core gui widgets
-CONFIG   += c11 console
+CONFIG   += c11 c++20 console
 TARGET   = tetris_gui  # Name of your executable
 TEMPLATE = app
 
@@ -9,7 +9,8 @@ TEMPLATE = app
 SOURCES += gui.cpp
 HEADERS += gui.h
 
-SOURCES += ../../brick_game/tetris/tetris.c ../../brick_game/GameController.cpp
+SOURCES += ../../brick_game/tetris/tetris.c ../../brick_game/tetris/tetris_bot.c ../../brick_game/GameController.cpp ../../brick_game/GameRunner.cpp
+LIBS += -pthread
 
 # Assuming game_controller.h and GameCommon.h are in a directory
 INCLUDEPATH += ../../brick_game ../../brick_game/tetris
@@ -1,7 +1,16 @@
 #include "../brick_game/snake/snake.h"
 
+#include "../brick_game/GameRunner.h"
+#include "../brick_game/SpscQueue.h"
+
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
 using namespace s21;
 
 // Test fixture for the Snake game
@@ -167,6 +176,28 @@ TEST_F(SnakeGameTest, GameOverSelfCollision) {
   destroyGameInfo(finalState);
 }
 
+// Test case for game over by turning back into the body
+TEST_F(SnakeGameTest, GameOverReverseIntoBody) {
+  userInput(Start, false);
+  userInput(Left, false);  // Up
+  userInput(Left, false);  // Left, straight into the first body segment
+  GameInfo_t state = updateCurrentState();
+  EXPECT_EQ(state.current_game_state, GAME_OVER_LOSE);
+  destroyGameInfo(state);
+}
+
+// Test case for key repeats not turning the snake again
+TEST_F(SnakeGameTest, HeldTurnActsOnce) {
+  userInput(Start, false);
+  userInput(Left, false);  // Up
+  userInput(Left, true);   // Key repeats; a turn here would hit the body
+  userInput(Left, true);
+  releaseInput(Left);
+  GameInfo_t state = updateCurrentState();
+  EXPECT_EQ(state.current_game_state, GAME_RUNNING);
+  destroyGameInfo(state);
+}
+
 // Test case for resetting the game
 TEST_F(SnakeGameTest, ResetGame) {
   userInput(Start, false);                  // Start
@@ -240,6 +271,422 @@ TEST_F(SnakeGameTest, EatApple) {
   }
 }
 
+// Test borrowing engine-owned frames instead of heap copies
+TEST_F(SnakeGameTest, BorrowFrame) {
+  const GameFrame_t* first = borrowCurrentState();
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->info.current_game_state, START_SCREEN);
+  EXPECT_EQ(first->info.field[FIELD_HEIGHT / 2][FIELD_WIDTH / 2], HEAD);
+
+  // Double buffered: the second frame never aliases the first one
+  const GameFrame_t* second = borrowCurrentState();
+  ASSERT_NE(second, nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(borrowCurrentState(), nullptr);
+
+  releaseCurrentState(first);
+  const GameFrame_t* third = borrowCurrentState();
+  EXPECT_EQ(third, first);
+  releaseCurrentState(second);
+  releaseCurrentState(third);
+}
+
+// Test the compatibility path returns the same data as a borrowed frame
+TEST_F(SnakeGameTest, BorrowFrameMatchesCopy) {
+  userInput(Start, false);
+  GameInfo_t copy = updateCurrentState();
+  const GameFrame_t* frame = borrowCurrentState();
+  ASSERT_NE(frame, nullptr);
+  // The borrowed frame is one tick ahead: the head moved one cell right
+  for (int i = 0; i < FIELD_HEIGHT; ++i) {
+    for (int j = 0; j + 1 < FIELD_WIDTH; ++j) {
+      if (copy.field[i][j] == HEAD) {
+        EXPECT_EQ(frame->info.field[i][j + 1], HEAD);
+        EXPECT_EQ(frame->info.field[i][j], BODY);
+      }
+    }
+  }
+  EXPECT_EQ(frame->info.score, copy.score);
+  releaseCurrentState(frame);
+  destroyGameInfo(copy);
+}
+
+// Test food is always placed on a cell the snake does not cover
+TEST_F(SnakeGameTest, FoodOnFreeCell) {
+  for (int game = 0; game < 200; ++game) {
+    SetUp();
+    userInput(Start, false);
+    for (int tick = 0; tick < 40; ++tick) {
+      userInput(tick % 7 == 3 ? Right : Left, false);
+      const GameFrame_t* frame = borrowCurrentState();
+      ASSERT_NE(frame, nullptr);
+      if (frame->info.current_game_state != GAME_RUNNING) {
+        releaseCurrentState(frame);
+        break;
+      }
+      int food = 0, head = 0, body = 0;
+      for (int i = 0; i < FIELD_HEIGHT; ++i) {
+        for (int j = 0; j < FIELD_WIDTH; ++j) {
+          food += frame->info.field[i][j] == FOOD;
+          head += frame->info.field[i][j] == HEAD;
+          body += frame->info.field[i][j] == BODY;
+        }
+      }
+      EXPECT_EQ(food, 1);
+      EXPECT_EQ(head, 1);
+      EXPECT_EQ(body, 3 + frame->info.score);
+      releaseCurrentState(frame);
+    }
+  }
+}
+
+// Test independent engines do not share state
+TEST(SnakeEngineTest, InstancesAreIndependent) {
+  SnakeEngine first(std::make_unique<MemoryHighScoreSink>());
+  SnakeEngine second(std::make_unique<MemoryHighScoreSink>());
+  first.handleUserInput(Start, false);
+
+  const GameFrame_t* running = first.borrowState();
+  const GameFrame_t* idle = second.borrowState();
+  EXPECT_EQ(running->info.current_game_state, GAME_RUNNING);
+  EXPECT_EQ(idle->info.current_game_state, START_SCREEN);
+  EXPECT_EQ(running->info.field[FIELD_HEIGHT / 2][FIELD_WIDTH / 2 + 1], HEAD);
+  EXPECT_EQ(idle->info.field[FIELD_HEIGHT / 2][FIELD_WIDTH / 2], HEAD);
+  first.releaseState(running);
+  second.releaseState(idle);
+}
+
+// Test a seed reproducing the same food sequence
+TEST(SnakeEngineTest, SeedIsDeterministic) {
+  SnakeEngine first(std::make_unique<MemoryHighScoreSink>(), 7);
+  SnakeEngine second(std::make_unique<MemoryHighScoreSink>());
+  second.seed(7);
+  first.handleUserInput(Start, false);
+  second.handleUserInput(Start, false);
+  for (int tick = 0; tick < 60; ++tick) {
+    UserAction_t turn = tick % 4 == 0 ? Right : Left;
+    first.handleUserInput(turn, false);
+    second.handleUserInput(turn, false);
+    const GameFrame_t* a = first.borrowState();
+    const GameFrame_t* b = second.borrowState();
+    for (int i = 0; i < FIELD_HEIGHT; ++i) {
+      for (int j = 0; j < FIELD_WIDTH; ++j) {
+        ASSERT_EQ(a->field_cells[i][j], b->field_cells[i][j]);
+      }
+    }
+    first.releaseState(a);
+    second.releaseState(b);
+  }
+}
+
+// Test a swapped sink supplying the high score
+TEST(SnakeEngineTest, SwappedSinkLoadsHighScore) {
+  SnakeEngine engine(std::make_unique<MemoryHighScoreSink>());
+  auto sink = std::make_unique<MemoryHighScoreSink>();
+  sink->save(42);
+  engine.setHighScoreSink(std::move(sink));
+  const GameFrame_t* frame = engine.borrowState();
+  EXPECT_EQ(frame->info.high_score, 42);
+  engine.releaseState(frame);
+}
+
+// Test time-based steps being independent of snapshots and time slicing
+TEST(SnakeEngineTest, StepFollowsElapsedTime) {
+  SnakeEngine engine(std::make_unique<MemoryHighScoreSink>(), 3);
+  engine.handleUserInput(Start, false);
+  const int row = FIELD_HEIGHT / 2;
+  const int start = FIELD_WIDTH / 2;
+  auto expectHeadAt = [&](int x) {
+    const GameFrame_t* frame = engine.snapshot();
+    EXPECT_EQ(frame->field_cells[row][x], HEAD);
+    engine.releaseState(frame);
+  };
+
+  engine.step(0.25);  // Half of the 500 ms interval
+  expectHeadAt(start);
+  expectHeadAt(start);  // Snapshots never move the snake
+  engine.step(0.25);
+  expectHeadAt(start + 1);
+  for (int frame = 0; frame < 30; ++frame) engine.step(1.0 / 60.0);
+  expectHeadAt(start + 2);
+  engine.step(1.0);  // One long step catches up on both moves
+  expectHeadAt(start + 4);
+
+  engine.handleUserInput(Pause, false);
+  engine.step(10.0);
+  expectHeadAt(start + 4);
+}
+
+// Test a long step being capped at one second of moves
+TEST(SnakeEngineTest, LongStepIsCapped) {
+  SnakeEngine engine(std::make_unique<MemoryHighScoreSink>(), 3);
+  engine.handleUserInput(Start, false);
+  engine.step(5.0);  // Two 500 ms moves, not ten
+  const GameFrame_t* frame = engine.snapshot();
+  EXPECT_EQ(frame->info.current_game_state, GAME_RUNNING);
+  EXPECT_EQ(frame->field_cells[FIELD_HEIGHT / 2][FIELD_WIDTH / 2 + 2], HEAD);
+  engine.releaseState(frame);
+}
+
+// Test a held boost repeating on the engine's timing, not the OS repeats
+TEST(SnakeEngineTest, HeldBoostRepeatsFromStep) {
+  SnakeEngine engine(std::make_unique<MemoryHighScoreSink>(), 3);
+  engine.setAutoRepeat(100, 50);
+  engine.handleUserInput(Start, false);
+  const int row = FIELD_HEIGHT / 2;
+  const int start = FIELD_WIDTH / 2;
+  auto expectHeadAt = [&](int x) {
+    const GameFrame_t* frame = engine.snapshot();
+    EXPECT_EQ(frame->field_cells[row][x], HEAD);
+    engine.releaseState(frame);
+  };
+
+  engine.handleUserInput(Action, false);  // Boosts at once
+  expectHeadAt(start + 1);
+  engine.handleUserInput(Action, true);  // OS repeats do nothing
+  engine.handleUserInput(Action, true);
+  expectHeadAt(start + 1);
+  engine.step(0.09);
+  expectHeadAt(start + 1);
+  engine.step(0.01);  // The delay is over
+  expectHeadAt(start + 2);
+  engine.step(0.1);  // Two repeats at 50 ms
+  expectHeadAt(start + 4);
+  engine.handleUserRelease(Action);
+  engine.step(0.2);  // Still short of the 500 ms move interval
+  expectHeadAt(start + 4);
+}
+
+// Test a restart forgetting a boost that was held into it
+TEST(SnakeEngineTest, RestartForgetsHeldBoost) {
+  SnakeEngine engine(std::make_unique<MemoryHighScoreSink>(), 3);
+  engine.handleUserInput(Start, false);
+  engine.handleUserInput(Action, false);
+  engine.resetGame();
+  engine.handleUserInput(Start, false);
+  engine.step(0.4);
+  const GameFrame_t* frame = engine.snapshot();
+  EXPECT_EQ(frame->field_cells[FIELD_HEIGHT / 2][FIELD_WIDTH / 2], HEAD);
+  engine.releaseState(frame);
+}
+
+// Test a frontend's step clock not replaying the wait for Start or unpause
+TEST(StepClockTest, IdleSpanIsNotGameTime) {
+  using Clock = s21_controller::StepClock::Clock;
+  using std::chrono::milliseconds;
+  s21_controller::StepClock clock;
+  SnakeEngine engine(std::make_unique<MemoryHighScoreSink>(), 3);
+  const int row = FIELD_HEIGHT / 2;
+  const int start = FIELD_WIDTH / 2;
+  auto expectHeadAt = [&](int x) {
+    const GameFrame_t* frame = engine.snapshot();
+    EXPECT_EQ(frame->info.current_game_state, GAME_RUNNING);
+    EXPECT_EQ(frame->field_cells[row][x], HEAD);
+    engine.releaseState(frame);
+  };
+  const Clock::time_point t0 = Clock::now();
+
+  EXPECT_EQ(clock.lap(t0), 0.0);  // Start screen, then the loop waits
+  clock.stop();
+  engine.handleUserInput(Start, false);  // Three seconds later
+  engine.step(clock.lap(t0 + milliseconds(3000)));
+  expectHeadAt(start);
+  engine.step(clock.lap(t0 + milliseconds(3500)));
+  expectHeadAt(start + 1);
+
+  engine.handleUserInput(Pause, false);
+  clock.stop();
+  engine.handleUserInput(Pause, false);  // A minute later
+  engine.step(clock.lap(t0 + milliseconds(63500)));
+  expectHeadAt(start + 1);
+  EXPECT_DOUBLE_EQ(clock.lap(t0 + milliseconds(63750)), 0.25);
+}
+
+// Test the runner ticking the default game and publishing its frames
+TEST_F(SnakeGameTest, RunnerTicksOnItsOwnThread) {
+  s21_controller::GameRunner runner(std::chrono::milliseconds(2));
+  runner.start();
+  ASSERT_NE(runner.latest(), nullptr);
+  EXPECT_EQ(runner.latest()->info.current_game_state, START_SCREEN);
+
+  runner.userInput(Start, false);
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  const GameFrame_t* frame = runner.latest();
+  while (frame->info.current_game_state != GAME_RUNNING &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    frame = runner.latest();
+  }
+  EXPECT_EQ(frame->info.current_game_state, GAME_RUNNING);
+  EXPECT_EQ(frame->info.field[0], frame->field_cells[0]);  // Rebound copy
+  runner.userInput(Pause, false);
+  runner.stop();
+  EXPECT_FALSE(runner.running());
+  EXPECT_GT(runner.jitterReport().ticks, 0u);
+}
+
+// Test the jitter percentiles against a known distribution
+TEST(JitterStatsTest, ReportsPercentiles) {
+  s21_controller::JitterStats stats;
+  EXPECT_EQ(stats.report().ticks, 0u);
+  for (int us = 1; us <= 100; ++us) {
+    stats.record(std::chrono::microseconds(us));
+  }
+  stats.record(std::chrono::nanoseconds(-500));  // Early counts as on time
+  const s21_controller::JitterReport report = stats.report();
+  EXPECT_EQ(report.ticks, 101u);
+  EXPECT_DOUBLE_EQ(report.p50_us, 50.0);
+  EXPECT_DOUBLE_EQ(report.p99_us, 99.0);
+  EXPECT_DOUBLE_EQ(report.max_us, 100.0);
+  EXPECT_NEAR(report.mean_us, 5050.0 / 101.0, 1e-9);
+  stats.reset();
+  EXPECT_EQ(stats.report().ticks, 0u);
+}
+
+// Test many engines running on separate threads
+TEST(SnakeEngineTest, InstancesRunOnThreads) {
+  const int kThreads = 8;
+  const int kEnginesPerThread = 64;
+  std::vector<int> finished(kThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t, &finished] {
+      std::vector<std::unique_ptr<SnakeEngine>> engines;
+      for (int e = 0; e < kEnginesPerThread; ++e) {
+        engines.push_back(std::make_unique<SnakeEngine>(
+            std::make_unique<MemoryHighScoreSink>()));
+        engines.back()->handleUserInput(Start, false);
+      }
+      // Every snake runs straight into the right wall
+      for (int tick = 0; tick < FIELD_WIDTH; ++tick) {
+        for (auto& engine : engines) {
+          engine->releaseState(engine->borrowState());
+        }
+      }
+      for (auto& engine : engines) {
+        const GameFrame_t* frame = engine->borrowState();
+        finished[t] += frame->info.current_game_state == GAME_OVER_LOSE;
+        engine->releaseState(frame);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (int count : finished) EXPECT_EQ(count, kEnginesPerThread);
+}
+
+// Test the fixed-capacity ring buffer backing the snake body
+TEST(RingBufferTest, PushPopWrapsAround) {
+  RingBuffer<int, 4> ring;
+  for (int round = 0; round < 10; ++round) {
+    ring.push_front(round);
+    if (ring.size() > 3) ring.pop_back();
+  }
+  ASSERT_EQ(ring.size(), 3u);
+  EXPECT_EQ(ring.front(), 9);
+  EXPECT_EQ(ring[1], 8);
+  EXPECT_EQ(ring.back(), 7);
+  ring.push_back(6);
+  EXPECT_EQ(ring.size(), ring.capacity());
+  EXPECT_EQ(ring.back(), 6);
+  ring.clear();
+  EXPECT_EQ(ring.size(), 0u);
+}
+
+// Test the SPSC queue keeping order, refusing when full and wrapping around
+TEST(SpscQueueTest, PushPopWrapsAround) {
+  SpscQueue<int, 4> queue;
+  int value = 0;
+  EXPECT_FALSE(queue.pop(&value));
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.push(round * 4 + i));
+    EXPECT_FALSE(queue.push(-1));
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(queue.pop(&value));
+      EXPECT_EQ(value, round * 4 + i);
+    }
+    EXPECT_FALSE(queue.pop(&value));
+  }
+}
+
+// Test the SPSC queue handing every element across threads in order
+TEST(SpscQueueTest, TransfersBetweenThreads) {
+  constexpr int kCount = 100000;
+  SpscQueue<int, 64> queue;
+  std::thread producer([&queue] {
+    for (int i = 0; i < kCount; ++i) {
+      while (!queue.push(i)) std::this_thread::yield();
+    }
+  });
+  int expected = 0;
+  int value = 0;
+  while (expected < kCount) {
+    if (!queue.pop(&value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(value, expected);
+    ++expected;
+  }
+  producer.join();
+}
+
+// Waits until the runner thread has applied `count` inputs and published
+// the frame of the tick that applied the last of them
+static bool waitForInputs(s21_controller::GameRunner& runner,
+                          std::uint64_t count) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  auto wait = [&](auto done) {
+    while (!done()) {
+      if (std::chrono::steady_clock::now() >= deadline) return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  };
+  if (!wait([&] { return runner.inputLatencyReport().ticks >= count; })) {
+    return false;
+  }
+  // A tick publishes before the next one starts
+  const std::uint64_t tick = runner.jitterReport().ticks;
+  return wait([&] { return runner.jitterReport().ticks > tick; });
+}
+
+// Test the runner thread applying every queued input
+TEST_F(SnakeGameTest, RunnerAppliesEveryInput) {
+  s21_controller::GameRunner runner(std::chrono::milliseconds(5));
+  runner.start();
+  // Losing any one of these inputs changes the state the game ends in
+  EXPECT_TRUE(runner.userInput(Start, false));
+  EXPECT_TRUE(runner.userInput(Pause, false));
+  EXPECT_TRUE(runner.userInput(Pause, false));
+  EXPECT_TRUE(runner.userInput(Pause, false));
+  ASSERT_TRUE(waitForInputs(runner, 4));
+  EXPECT_TRUE(runner.running());
+  EXPECT_EQ(runner.latest()->info.current_game_state, PAUSED);
+  runner.stop();
+  EXPECT_EQ(runner.droppedInputs(), 0u);
+  EXPECT_EQ(runner.inputLatencyReport().ticks, 4u);
+}
+
+// Test the runner thread applying inputs in the order they were sent
+TEST_F(SnakeGameTest, RunnerAppliesInputsInOrder) {
+  s21_controller::GameRunner runner(std::chrono::milliseconds(5));
+  runner.start();
+  EXPECT_TRUE(runner.userInput(Start, false));
+  ASSERT_TRUE(waitForInputs(runner, 1));
+  ASSERT_EQ(runner.latest()->info.current_game_state, GAME_RUNNING);
+
+  // Pause then Start resets to the start screen; the other way round, the
+  // running game ignores Start and ends up paused
+  EXPECT_TRUE(runner.userInput(Pause, false));
+  EXPECT_TRUE(runner.userInput(Start, false));
+  ASSERT_TRUE(waitForInputs(runner, 3));
+  EXPECT_TRUE(runner.running());
+  EXPECT_EQ(runner.latest()->info.current_game_state, START_SCREEN);
+  runner.stop();
+}
+
 // Main function for running the tests
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
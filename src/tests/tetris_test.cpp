@@ -0,0 +1,886 @@
+#include "../brick_game/tetris/tetris.h"
+#include "../brick_game/tetris/tetris_bot.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace s21;
+
+// Test fixture for the Tetris game, one in-memory context per test
+class TetrisGameTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ctx = tetris_create(nullptr); }
+  void TearDown() override { tetris_destroy(ctx); }
+
+  // Counts cells of a frame's field holding the given state
+  static int countCells(const GameFrame_t& frame, int state) {
+    int count = 0;
+    for (int r = 0; r < FIELD_HEIGHT; ++r) {
+      for (int c = 0; c < FIELD_WIDTH; ++c) {
+        count += frame.info.field[r][c] == state;
+      }
+    }
+    return count;
+  }
+
+  // Topmost row with an occupied cell, FIELD_HEIGHT if the field is empty
+  static int topRow(const GameFrame_t& frame) {
+    for (int r = 0; r < FIELD_HEIGHT; ++r) {
+      for (int c = 0; c < FIELD_WIDTH; ++c) {
+        if (frame.info.field[r][c] != EMPTY) return r;
+      }
+    }
+    return FIELD_HEIGHT;
+  }
+
+  TetrisContext* ctx = nullptr;
+};
+
+// Test case for initial game state
+TEST_F(TetrisGameTest, InitialState) {
+  ASSERT_NE(ctx, nullptr);
+  GameFrame_t frame;
+  tetris_snapshot(ctx, &frame);
+  EXPECT_EQ(frame.info.current_game_state, START_SCREEN);
+  EXPECT_EQ(frame.info.score, 0);
+  EXPECT_EQ(frame.info.level, 1);
+  EXPECT_EQ(frame.info.speed, 500);
+  EXPECT_EQ(countCells(frame, EMPTY), FIELD_WIDTH * FIELD_HEIGHT);
+}
+
+// Test case for starting the game and spawning the first piece
+TEST_F(TetrisGameTest, StartSpawnsPiece) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  GameFrame_t frame;
+  tetris_snapshot(ctx, &frame);
+  EXPECT_EQ(frame.info.current_game_state, GAME_RUNNING);
+  EXPECT_EQ(countCells(frame, BODY), 4);
+}
+
+// Test case for the optional ghost piece marking the landing cells
+TEST_F(TetrisGameTest, GhostShowsLandingCells) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  GameFrame_t frame;
+  tetris_snapshot(ctx, &frame);
+  EXPECT_EQ(countCells(frame, GHOST), 0);
+
+  tetris_set_ghost(ctx, true);
+  tetris_snapshot(ctx, &frame);
+  EXPECT_EQ(countCells(frame, GHOST), 4);
+  EXPECT_EQ(countCells(frame, BODY), 4);
+  int bottom_ghosts = 0;
+  for (int c = 0; c < FIELD_WIDTH; ++c) {
+    bottom_ghosts += frame.info.field[FIELD_HEIGHT - 1][c] == GHOST;
+  }
+  EXPECT_GT(bottom_ghosts, 0);
+}
+
+// Test case for Up dropping the piece straight onto the floor and locking it
+TEST_F(TetrisGameTest, HardDropLocksOnLandingRow) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  GameFrame_t frame;
+  tetris_snapshot(ctx, &frame);
+  EXPECT_EQ(frame.landing_row, FIELD_HEIGHT - 1);
+
+  tetris_input(ctx, Up, false);  // Locks at once and spawns the next
+  EXPECT_GT(tetris_metrics(ctx)->aggregate_height, 0);
+  EXPECT_NE(ctx->board.rows[TETRIS_BOARD_HEIGHT - 1], TETRIS_ROW_EMPTY);
+  EXPECT_TRUE(ctx->current_piece.active);
+  EXPECT_EQ(ctx->current_fsm_state, TETRIS_STATE_MOVING);
+  EXPECT_EQ(ctx->current_piece.y, TETRIS_SPAWN_Y);
+}
+
+// Test case for a long advance being capped at one second of gravity
+TEST_F(TetrisGameTest, LongAdvanceIsCapped) {
+  tetris_input(ctx, Start, false);
+  tetris_advance(ctx, 0.0);  // Spawn
+  ASSERT_EQ(ctx->current_piece.y, TETRIS_SPAWN_Y);
+  tetris_advance(ctx, 5.0);  // Two rows at level 1, not ten
+  EXPECT_EQ(ctx->current_piece.y, TETRIS_SPAWN_Y + 2);
+}
+
+// Test case for the entry delay holding back the next piece
+TEST_F(TetrisGameTest, EntryDelayPostponesSpawn) {
+  tetris_set_entry_delay(ctx, 100);
+  tetris_input(ctx, Start, false);
+  tetris_advance(ctx, 0.0);  // The first piece spawns at once
+  ASSERT_TRUE(ctx->current_piece.active);
+
+  tetris_input(ctx, Up, false);  // Locks, then waits
+  tetris_advance(ctx, 0.0);
+  EXPECT_FALSE(ctx->current_piece.active);
+  EXPECT_EQ(ctx->current_fsm_state, TETRIS_STATE_SPAWN);
+  tetris_advance(ctx, 0.06);
+  EXPECT_FALSE(ctx->current_piece.active);
+  tetris_advance(ctx, 0.06);
+  EXPECT_TRUE(ctx->current_piece.active);
+  EXPECT_EQ(ctx->current_fsm_state, TETRIS_STATE_MOVING);
+
+  // Discrete ticks do not wait
+  tetris_input(ctx, Up, false);
+  EXPECT_FALSE(ctx->current_piece.active);
+  tetris_step(ctx);
+  EXPECT_TRUE(ctx->current_piece.active);
+}
+
+// Test case for the landing row agreeing with row-by-row probing
+TEST(TetrisLandingTest, LandingRowMatchesProbing) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 11);
+  GameRandom_t rng;
+  seedGameRandom(&rng, 5);
+  const UserAction_t moves[] = {Left, Right, Action, Down, Up};
+  GameFrame_t frame;
+  for (int game = 0; game < 10; ++game) {
+    tetris_input(ctx, Start, false);
+    for (int tick = 0; tick < 500 && ctx->overall_game_state == GAME_RUNNING; ++tick) {
+      tetris_input(ctx, moves[boundedGameRandom(&rng, 5)], false);
+      tetris_step(ctx);
+      tetris_snapshot(ctx, &frame);
+      const CurrentPieceState& p = ctx->current_piece;
+      if (!p.active) {
+        EXPECT_EQ(frame.landing_row, -1);
+        continue;
+      }
+      int y = p.y;
+      while (tetris_piece_fits(ctx, p.x, y + 1, p.type, p.rotation)) ++y;
+      ASSERT_EQ(frame.landing_row, y + tetromino_layouts[p.type][p.rotation].max_y);
+    }
+  }
+  tetris_destroy(ctx);
+}
+
+// Test case for gravity moving the piece one row per step
+TEST_F(TetrisGameTest, GravityMovesPieceDown) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  GameFrame_t before, after;
+  tetris_snapshot(ctx, &before);
+  tetris_step(ctx);
+  tetris_snapshot(ctx, &after);
+  EXPECT_EQ(topRow(after), topRow(before) + 1);
+}
+
+// Test case for snapshots not advancing the game
+TEST_F(TetrisGameTest, SnapshotHasNoSideEffects) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  GameFrame_t first, second;
+  tetris_snapshot(ctx, &first);
+  tetris_snapshot(ctx, &second);
+  for (int r = 0; r < FIELD_HEIGHT; ++r) {
+    for (int c = 0; c < FIELD_WIDTH; ++c) {
+      EXPECT_EQ(first.field_cells[r][c], second.field_cells[r][c]);
+    }
+  }
+}
+
+// Test case for pausing and unpausing the game
+TEST_F(TetrisGameTest, PauseAndUnpause) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  tetris_input(ctx, Pause, false);
+  tetris_step(ctx);
+  const GameFrame_t* frame = tetris_borrow_frame(ctx);
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(frame->info.current_game_state, PAUSED);
+  EXPECT_EQ(frame->info.pause, 1);
+  tetris_release_frame(ctx, frame);
+
+  tetris_input(ctx, Pause, false);
+  tetris_step(ctx);
+  frame = tetris_borrow_frame(ctx);
+  EXPECT_EQ(frame->info.current_game_state, GAME_RUNNING);
+  EXPECT_EQ(frame->info.pause, 0);
+  tetris_release_frame(ctx, frame);
+}
+
+// Test case for pieces stacking up until the game is lost
+TEST_F(TetrisGameTest, StackingLosesGame) {
+  tetris_input(ctx, Start, false);
+  GameFrame_t frame;
+  for (int step = 0; step < 10000; ++step) {
+    tetris_step(ctx);
+    tetris_snapshot(ctx, &frame);
+    if (frame.info.current_game_state == GAME_OVER_LOSE) break;
+  }
+  EXPECT_EQ(frame.info.current_game_state, GAME_OVER_LOSE);
+
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  tetris_snapshot(ctx, &frame);
+  EXPECT_EQ(frame.info.current_game_state, GAME_RUNNING);
+  EXPECT_EQ(countCells(frame, BODY), 4);
+}
+
+// Test case for terminating the game
+TEST_F(TetrisGameTest, TerminateGame) {
+  tetris_input(ctx, Start, false);
+  tetris_input(ctx, Terminate, false);
+  tetris_step(ctx);
+  GameFrame_t frame;
+  tetris_snapshot(ctx, &frame);
+  EXPECT_EQ(frame.info.current_game_state, TERMINATE_GAME);
+}
+
+// Test case for the bitboard collision test against walls, floor and blocks
+TEST_F(TetrisGameTest, PieceFitsWallsAndFloor) {
+  // Horizontal I occupies row 1 of its grid, columns 0..3
+  EXPECT_TRUE(tetris_piece_fits(ctx, 0, 0, 0, 0));
+  EXPECT_TRUE(tetris_piece_fits(ctx, TETRIS_BOARD_WIDTH - 4, 0, 0, 0));
+  EXPECT_FALSE(tetris_piece_fits(ctx, -1, 0, 0, 0));
+  EXPECT_FALSE(tetris_piece_fits(ctx, TETRIS_BOARD_WIDTH - 3, 0, 0, 0));
+  EXPECT_TRUE(tetris_piece_fits(ctx, 0, TETRIS_BOARD_HEIGHT - 2, 0, 0));
+  EXPECT_FALSE(tetris_piece_fits(ctx, 0, TETRIS_BOARD_HEIGHT - 1, 0, 0));
+  EXPECT_FALSE(tetris_piece_fits(ctx, 0, -2, 0, 0));
+  EXPECT_FALSE(tetris_piece_fits(ctx, 0, 100, 0, 0));
+
+  ctx->board.rows[TETRIS_BOARD_HEIGHT - 1] |= 1u << (2 + TETRIS_WALL_BITS);
+  EXPECT_FALSE(tetris_piece_fits(ctx, 0, TETRIS_BOARD_HEIGHT - 2, 0, 0));
+  EXPECT_TRUE(tetris_piece_fits(ctx, 3, TETRIS_BOARD_HEIGHT - 2, 0, 0));
+}
+
+// Test case for a multi-line clear compacting the board and reporting rows
+TEST_F(TetrisGameTest, LineClearReportsRows) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  const unsigned column0 = 1u << TETRIS_WALL_BITS;
+  const unsigned column5 = 1u << (5 + TETRIS_WALL_BITS);
+  // Rows 16, 17 and 19 miss only column 0, row 18 also misses column 5
+  ctx->board.rows[16] = TETRIS_ROW_FULL & ~column0;
+  ctx->board.rows[17] = TETRIS_ROW_FULL & ~column0;
+  ctx->board.rows[18] = TETRIS_ROW_FULL & ~column0 & ~column5;
+  ctx->board.rows[19] = TETRIS_ROW_FULL & ~column0;
+  // A vertical I in column 0 resting on the floor fills all four gaps
+  ctx->current_piece.type = 0;
+  ctx->current_piece.rotation = 3;
+  ctx->current_piece.x = -1;
+  ctx->current_piece.y = 16;
+  tetris_step(ctx);  // Cannot fall further: locks, clears and spawns
+
+  const TetrisLineClear* clear = tetris_last_clear(ctx);
+  ASSERT_EQ(clear->count, 3);
+  EXPECT_EQ(clear->rows[0], 19);
+  EXPECT_EQ(clear->rows[1], 17);
+  EXPECT_EQ(clear->rows[2], 16);
+  EXPECT_EQ(ctx->board.rows[19], TETRIS_ROW_FULL & ~column5);
+  for (int r = 0; r < TETRIS_BOARD_HEIGHT - 1; ++r) {
+    EXPECT_EQ(ctx->board.rows[r], TETRIS_ROW_EMPTY) << "row " << r;
+  }
+  EXPECT_EQ(ctx->score, 700);
+}
+
+// Recounts the stack metrics from the row bitboard and compares them
+static void expectMetricsMatchBoard(const TetrisContext* ctx) {
+  TetrisBoardMetrics expected{};
+  for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
+    int top = TETRIS_BOARD_HEIGHT;
+    for (int r = TETRIS_BOARD_HEIGHT - 1; r >= 0; --r) {
+      if ((ctx->board.rows[r] >> (c + TETRIS_WALL_BITS)) & 1u) top = r;
+    }
+    expected.heights[c] = TETRIS_BOARD_HEIGHT - top;
+    for (int r = top; r < TETRIS_BOARD_HEIGHT; ++r) {
+      expected.holes[c] += !((ctx->board.rows[r] >> (c + TETRIS_WALL_BITS)) & 1u);
+    }
+    expected.aggregate_height += expected.heights[c];
+    expected.total_holes += expected.holes[c];
+  }
+  for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
+    int left = c > 0 ? expected.heights[c - 1] : TETRIS_BOARD_HEIGHT;
+    int right = c < TETRIS_BOARD_WIDTH - 1 ? expected.heights[c + 1] : TETRIS_BOARD_HEIGHT;
+    expected.well_depths[c] = std::max(0, std::min(left, right) - expected.heights[c]);
+    if (c > 0) expected.bumpiness += std::abs(expected.heights[c] - expected.heights[c - 1]);
+  }
+
+  const TetrisBoardMetrics* m = tetris_metrics(ctx);
+  ASSERT_EQ(m->aggregate_height, expected.aggregate_height);
+  ASSERT_EQ(m->total_holes, expected.total_holes);
+  ASSERT_EQ(m->bumpiness, expected.bumpiness);
+  for (int c = 0; c < TETRIS_BOARD_WIDTH; ++c) {
+    ASSERT_EQ(m->heights[c], expected.heights[c]) << "column " << c;
+    ASSERT_EQ(m->holes[c], expected.holes[c]) << "column " << c;
+    ASSERT_EQ(m->well_depths[c], expected.well_depths[c]) << "column " << c;
+  }
+}
+
+// Replaces the falling piece and hard drops it, which spawns the next one
+static void dropPiece(TetrisContext* ctx, int type, int rotation, int x) {
+  ctx->current_piece.type = type;
+  ctx->current_piece.rotation = rotation;
+  ctx->current_piece.x = x;
+  ctx->current_piece.y = 0;
+  tetris_input(ctx, Up, false);
+}
+
+// Test case for the incremental metrics matching a from-scratch recount
+TEST(TetrisMetricsTest, MetricsTrackRandomPlay) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 7);
+  GameRandom_t rng;
+  seedGameRandom(&rng, 99);
+  const UserAction_t moves[] = {Left, Right, Up, Down, Action};
+  for (int game = 0; game < 5; ++game) {
+    tetris_input(ctx, Start, false);
+    for (int tick = 0; tick < 2000 && ctx->overall_game_state != GAME_OVER_LOSE; ++tick) {
+      tetris_input(ctx, moves[boundedGameRandom(&rng, 5)], false);
+      tetris_step(ctx);
+      expectMetricsMatchBoard(ctx);
+    }
+  }
+  tetris_destroy(ctx);
+}
+
+// Test case for the metrics following a two-line clear over a hole
+TEST(TetrisMetricsTest, MetricsFollowLineClears) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  dropPiece(ctx, 0, 3, -1);  // Vertical I in column 0
+  dropPiece(ctx, 0, 0, 1);   // Horizontal I on columns 1-4, bottom row
+  dropPiece(ctx, 5, 2, 2);   // T pointing down onto it, leaves holes
+  expectMetricsMatchBoard(ctx);
+  EXPECT_GT(tetris_metrics(ctx)->total_holes, 0);
+  EXPECT_EQ(tetris_metrics(ctx)->well_depths[9], 0);
+  dropPiece(ctx, 3, 0, 4);  // O pieces on columns 5-8
+  expectMetricsMatchBoard(ctx);
+  dropPiece(ctx, 3, 0, 6);
+  expectMetricsMatchBoard(ctx);
+  EXPECT_EQ(tetris_metrics(ctx)->well_depths[9], 2);
+  dropPiece(ctx, 0, 3, 8);  // Vertical I in column 9 completes the bottom row
+  EXPECT_EQ(tetris_last_clear(ctx)->count, 1);
+  expectMetricsMatchBoard(ctx);
+  tetris_destroy(ctx);
+}
+
+// Test case for the generated layout tables agreeing with the 4x4 shapes
+TEST(TetrominoTableTest, LayoutsMatchShapes) {
+  for (int t = 0; t < NUM_TETROMINO_TYPES; ++t) {
+    for (int rot = 0; rot < NUM_TETROMINO_ROTATIONS; ++rot) {
+      const TetrominoShape& shape = tetrominoes[t][rot];
+      const TetrominoLayout& layout = tetromino_layouts[t][rot];
+      int blocks = 0;
+      for (int r = 0; r < TETROMINO_GRID_SIZE; ++r) {
+        int mask = 0;
+        for (int c = 0; c < TETROMINO_GRID_SIZE; ++c) {
+          if (shape.shape[r][c] != 1) continue;
+          mask |= 1 << c;
+          ++blocks;
+          EXPECT_GE(r, layout.min_y);
+          EXPECT_LE(r, layout.max_y);
+          EXPECT_GE(c, layout.min_x);
+          EXPECT_LE(c, layout.max_x);
+          EXPECT_GE(layout.column_bottom[c], r);
+        }
+        EXPECT_EQ(layout.row_masks[r], mask) << "type " << t << " rot " << rot;
+      }
+      EXPECT_EQ(blocks, TETROMINO_CELL_COUNT);
+      for (int i = 0; i < TETROMINO_CELL_COUNT; ++i) {
+        EXPECT_EQ(shape.shape[layout.cells[i][1]][layout.cells[i][0]], 1);
+      }
+      for (int c = 0; c < TETROMINO_GRID_SIZE; ++c) {
+        int bottom = layout.column_bottom[c];
+        if (bottom >= 0) {
+          EXPECT_EQ(shape.shape[bottom][c], 1);
+        }
+      }
+    }
+  }
+}
+
+// Test case for the bot's move reaching the placement it reports
+TEST(TetrisBotTest, MoveReachesReportedPlacement) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 3);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  TetrisBot* bot = tetris_bot_create(1);
+  TetrisBotMove move = tetris_bot_search(bot, ctx, false);
+  ASSERT_TRUE(move.found);
+  ASSERT_GT(move.action_count, 0);
+  EXPECT_EQ(move.actions[move.action_count - 1], Up);
+  for (int i = 0; i < move.action_count - 1; ++i) {
+    tetris_input(ctx, move.actions[i], false);
+  }
+  EXPECT_EQ(ctx->current_piece.x, move.x);
+  EXPECT_EQ(ctx->current_piece.rotation, move.rotation);
+  const int type = ctx->current_piece.type;
+  EXPECT_TRUE(tetris_piece_fits(ctx, move.x, move.y, type, move.rotation));
+  EXPECT_FALSE(tetris_piece_fits(ctx, move.x, move.y + 1, type, move.rotation));
+  tetris_input(ctx, Up, false);  // Locks the piece where the bot said
+  EXPECT_FALSE(tetris_piece_fits(ctx, move.x, move.y, type, move.rotation));
+  EXPECT_GT(tetris_bot_evaluations(bot), 0u);
+  tetris_bot_destroy(bot);
+  tetris_destroy(ctx);
+}
+
+// Test case for searches giving the same move on any number of threads
+TEST(TetrisBotTest, ThreadCountDoesNotChangeTheMove) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 17);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  TetrisBot* single = tetris_bot_create(1);
+  TetrisBot* pool = tetris_bot_create(4);
+  EXPECT_EQ(tetris_bot_threads(pool), 4);
+  for (int piece = 0; piece < 20 && ctx->current_piece.active; ++piece) {
+    TetrisBotMove a = tetris_bot_search(single, ctx, true);
+    TetrisBotMove b = tetris_bot_search(pool, ctx, true);
+    ASSERT_TRUE(a.found);
+    EXPECT_EQ(a.x, b.x);
+    EXPECT_EQ(a.y, b.y);
+    EXPECT_EQ(a.rotation, b.rotation);
+    EXPECT_DOUBLE_EQ(a.score, b.score);
+    for (int i = 0; i < a.action_count; ++i) tetris_input(ctx, a.actions[i], false);
+  }
+  tetris_bot_destroy(pool);
+  tetris_bot_destroy(single);
+  tetris_destroy(ctx);
+}
+
+// Test case for the Autopilot action letting the bot clear lines
+TEST(TetrisBotTest, AutopilotClearsLines) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 42);
+  tetris_input(ctx, Start, false);
+  tetris_input(ctx, Autopilot, false);
+  ASSERT_NE(ctx->autopilot, nullptr);
+  for (int tick = 0; tick < 600; ++tick) tetris_step(ctx);
+  EXPECT_EQ(ctx->overall_game_state, GAME_RUNNING);
+  EXPECT_GT(ctx->score, 0);
+  tetris_input(ctx, Autopilot, false);
+  EXPECT_EQ(ctx->autopilot, nullptr);
+
+  tetris_set_autopilot(ctx, true);
+  ASSERT_NE(ctx->autopilot, nullptr);
+  EXPECT_EQ(tetris_bot_threads(ctx->autopilot), 1);
+  tetris_input(ctx, Terminate, false);
+  EXPECT_EQ(ctx->autopilot, nullptr);
+  tetris_destroy(ctx);
+}
+
+// Test case for the autopilot searching once per piece and landing pieces at
+// the game's pace rather than the caller's tick rate
+TEST(TetrisBotTest, AutopilotPlaysOnePiecePerSpawn) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 42);
+  tetris_input(ctx, Start, false);
+  tetris_advance(ctx, 0.0);  // Spawn
+  tetris_set_autopilot(ctx, true);
+  tetris_advance(ctx, 0.0);  // Plan the piece
+  const unsigned long spawned = ctx->pieces_spawned;
+  const unsigned long long evaluations = tetris_bot_evaluations(ctx->autopilot);
+  ASSERT_GT(evaluations, 0u);
+
+  // A 10 ms ticker, well inside one gravity period: still the same piece,
+  // and no further search for it
+  for (int tick = 0; tick < 40; ++tick) tetris_advance(ctx, 0.01);
+  EXPECT_EQ(ctx->pieces_spawned, spawned);
+  EXPECT_EQ(tetris_bot_evaluations(ctx->autopilot), evaluations);
+
+  // Ten seconds at level 1: pieces land at most once per gravity period
+  for (int tick = 0; tick < 1000; ++tick) tetris_advance(ctx, 0.01);
+  EXPECT_GT(ctx->pieces_spawned, spawned);
+  EXPECT_LE(ctx->pieces_spawned - spawned, 10.0 * tetris_gravity(ctx) + 1);
+  EXPECT_EQ(ctx->overall_game_state, GAME_RUNNING);
+  tetris_destroy(ctx);
+}
+
+// Test case for a one-piece beam choosing the same move as the greedy search
+TEST(TetrisBotTest, ShallowPlanMatchesSearch) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 5);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  TetrisBot* bot = tetris_bot_create(1);
+  TetrisBotBeam beam = tetris_bot_default_beam;
+  beam.depth = 1;
+  ASSERT_TRUE(tetris_bot_set_beam(bot, &beam));
+  for (int piece = 0; piece < 20 && ctx->current_piece.active; ++piece) {
+    TetrisBotMove greedy = tetris_bot_search(bot, ctx, false);
+    TetrisBotMove plan = tetris_bot_plan(bot, ctx, nullptr, 0);
+    ASSERT_TRUE(plan.found);
+    EXPECT_EQ(plan.x, greedy.x);
+    EXPECT_EQ(plan.y, greedy.y);
+    EXPECT_EQ(plan.rotation, greedy.rotation);
+    EXPECT_DOUBLE_EQ(plan.score, greedy.score);
+    for (int i = 0; i < plan.action_count; ++i) tetris_input(ctx, plan.actions[i], false);
+  }
+  tetris_bot_destroy(bot);
+  tetris_destroy(ctx);
+}
+
+// Test case for beam plans not depending on the thread count
+TEST(TetrisBotTest, PlanDoesNotDependOnThreads) {
+  const int queue[] = {1, 4, 6, 0, 2, 5, 3};
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 11);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  TetrisBot* single = tetris_bot_create(1);
+  TetrisBot* pool = tetris_bot_create(3);
+  TetrisBotBeam beam = {16, 4, 12};
+  ASSERT_TRUE(tetris_bot_set_beam(single, &beam));
+  ASSERT_TRUE(tetris_bot_set_beam(pool, &beam));
+  for (int piece = 0; piece < 10 && ctx->current_piece.active; ++piece) {
+    TetrisBotMove a = tetris_bot_plan(single, ctx, queue + piece % 4, 3);
+    TetrisBotMove b = tetris_bot_plan(pool, ctx, queue + piece % 4, 3);
+    ASSERT_TRUE(a.found);
+    EXPECT_EQ(a.x, b.x);
+    EXPECT_EQ(a.rotation, b.rotation);
+    EXPECT_DOUBLE_EQ(a.score, b.score);
+    for (int i = 0; i < a.action_count; ++i) tetris_input(ctx, a.actions[i], false);
+  }
+  EXPECT_EQ(tetris_bot_evaluations(single), tetris_bot_evaluations(pool));
+  EXPECT_EQ(tetris_bot_transpositions(single), tetris_bot_transpositions(pool));
+  tetris_bot_destroy(pool);
+  tetris_bot_destroy(single);
+  tetris_destroy(ctx);
+}
+
+// Test case for boards reached in either order being merged
+TEST(TetrisBotTest, PlanMergesTranspositions) {
+  const int kO = 3;
+  const int queue[] = {kO, kO};
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  ctx->current_piece.type = kO;
+  TetrisBot* bot = tetris_bot_create(1);
+  TetrisBotBeam beam = {1000, 2, 14};
+  ASSERT_TRUE(tetris_bot_set_beam(bot, &beam));
+  EXPECT_TRUE(tetris_bot_plan(bot, ctx, queue, 2).found);
+  // Two O pieces side by side land the same in either order
+  EXPECT_GT(tetris_bot_transpositions(bot), 0u);
+  EXPECT_GT(tetris_bot_memory(bot), sizeof(TetrisBotBeam));
+  beam.depth = TETRIS_BOT_MAX_DEPTH + 1;
+  EXPECT_FALSE(tetris_bot_set_beam(bot, &beam));
+  tetris_bot_destroy(bot);
+  tetris_destroy(ctx);
+}
+
+// Test case for every seven consecutive pieces being one full bag
+TEST(TetrisPreviewTest, PiecesComeInBags) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 21);
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  TetrisBot* bot = tetris_bot_create(1);
+  for (int bag = 0; bag < 4; ++bag) {
+    int seen[NUM_TETROMINO_TYPES] = {0};
+    for (int piece = 0; piece < NUM_TETROMINO_TYPES; ++piece) {
+      ASSERT_TRUE(ctx->current_piece.active);
+      ++seen[ctx->current_piece.type];
+      TetrisBotMove move = tetris_bot_search(bot, ctx, true);
+      for (int i = 0; i < move.action_count; ++i) tetris_input(ctx, move.actions[i], false);
+    }
+    for (int type = 0; type < NUM_TETROMINO_TYPES; ++type) EXPECT_EQ(seen[type], 1);
+  }
+  tetris_bot_destroy(bot);
+  tetris_destroy(ctx);
+}
+
+// Test case for the frame's preview advancing as pieces spawn
+TEST(TetrisPreviewTest, FrameListsUpcomingPieces) {
+  TetrisContext* ctx = tetris_create(nullptr);
+  tetris_seed(ctx, 8);
+  tetris_input(ctx, Start, false);
+  GameFrame_t frame;
+  bindGameFrame(&frame);
+  tetris_snapshot(ctx, &frame);
+  ASSERT_EQ(frame.preview_count, TETRIS_PREVIEW_LENGTH);
+  int before[TETRIS_PREVIEW_LENGTH];
+  std::copy(frame.preview, frame.preview + TETRIS_PREVIEW_LENGTH, before);
+
+  tetris_step(ctx);  // Spawn
+  EXPECT_EQ(ctx->current_piece.type, before[0]);
+  tetris_snapshot(ctx, &frame);
+  for (int i = 0; i + 1 < TETRIS_PREVIEW_LENGTH; ++i) {
+    EXPECT_EQ(frame.preview[i], before[i + 1]);
+    EXPECT_EQ(tetris_preview_piece(ctx, i), frame.preview[i]);
+  }
+  // The 4x4 next grid shows the head of the preview
+  const TetrominoLayout& next = tetromino_layouts[frame.preview[0]][0];
+  for (int i = 0; i < TETROMINO_CELL_COUNT; ++i) {
+    EXPECT_EQ(frame.info.next[next.cells[i][1]][next.cells[i][0]], BODY);
+  }
+  tetris_destroy(ctx);
+}
+
+// Test case for rotating both ways through the SRS states in open space
+TEST_F(TetrisGameTest, RotatesBothWays) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  ctx->current_piece.type = 5;  // T
+  ctx->current_piece.y = 5;
+  const int x = ctx->current_piece.x;
+  tetris_input(ctx, AltAction, false);
+  EXPECT_EQ(ctx->current_piece.rotation, 3);
+  tetris_input(ctx, Action, false);
+  tetris_input(ctx, Action, false);
+  EXPECT_EQ(ctx->current_piece.rotation, 1);
+  tetris_input(ctx, AltAction, false);
+  EXPECT_EQ(ctx->current_piece.rotation, 0);
+  EXPECT_EQ(ctx->current_piece.x, x);
+  EXPECT_EQ(ctx->current_piece.y, 5);
+}
+
+// Test case for wall kicks moving a piece off the wall it rotates into
+TEST_F(TetrisGameTest, WallKicksAwayFromWalls) {
+  tetris_input(ctx, Start, false);
+  tetris_step(ctx);
+  // Vertical I against the right wall: R -> 2 kicks one column left
+  ctx->current_piece.type = 0;
+  ctx->current_piece.rotation = 1;
+  ctx->current_piece.x = TETRIS_BOARD_WIDTH - 3;
+  ctx->current_piece.y = 5;
+  tetris_input(ctx, Action, false);
+  EXPECT_EQ(ctx->current_piece.rotation, 2);
+  EXPECT_EQ(ctx->current_piece.x, TETRIS_BOARD_WIDTH - 4);
+  EXPECT_EQ(ctx->current_piece.y, 5);
+
+  // T pointing right against the left wall: R -> 2 kicks one column right
+  int x = -1, y = 5, rotation = 1;
+  ASSERT_TRUE(tetris_board_fits(&ctx->board, x, y, 5, rotation));
+  EXPECT_TRUE(tetris_board_rotate(&ctx->board, 5, &x, &y, &rotation, 1));
+  EXPECT_EQ(rotation, 2);
+  EXPECT_EQ(x, 0);
+  // T pointing left against the right wall: L -> 0 kicks one column left
+  x = TETRIS_BOARD_WIDTH - 2;
+  rotation = 3;
+  ASSERT_TRUE(tetris_board_fits(&ctx->board, x, y, 5, rotation));
+  EXPECT_TRUE(tetris_board_rotate(&ctx->board, 5, &x, &y, &rotation, 1));
+  EXPECT_EQ(rotation, 0);
+  EXPECT_EQ(x, TETRIS_BOARD_WIDTH - 3);
+
+  // A piece boxed in on every side keeps its position
+  for (int r = 0; r < TETRIS_BOARD_HEIGHT; ++r) ctx->board.rows[r] = TETRIS_ROW_FULL;
+  x = 3;
+  y = 5;
+  rotation = 0;
+  EXPECT_FALSE(tetris_board_rotate(&ctx->board, 5, &x, &y, &rotation, -1));
+  EXPECT_EQ(x, 3);
+  EXPECT_EQ(y, 5);
+  EXPECT_EQ(rotation, 0);
+}
+
+// Test case for gravity depending on elapsed time, not on the update rate
+TEST_F(TetrisGameTest, GravityFollowsElapsedTime) {
+  tetris_input(ctx, Start, false);
+  tetris_advance(ctx, 0.0);  // Spawn
+  ASSERT_EQ(ctx->current_fsm_state, TETRIS_STATE_MOVING);
+  const double gravity = tetris_gravity(ctx);
+  ASSERT_GT(gravity, 0.0);
+  const int start_y = ctx->current_piece.y;
+
+  // Three rows' worth of time at 144 updates per second
+  const double frame = 1.0 / 144.0;
+  const int frames = static_cast<int>(3.0 / gravity / frame) + 1;
+  for (int f = 0; f < frames; ++f) tetris_advance(ctx, frame);
+  EXPECT_EQ(ctx->current_piece.y, start_y + 3);
+
+  // A single update drops just as far, up to the one-second cap
+  tetris_advance(ctx, 2.0 / gravity);
+  EXPECT_EQ(ctx->current_piece.y, start_y + 5);
+
+  // Paused games do not accumulate gravity
+  tetris_input(ctx, Pause, false);
+  tetris_advance(ctx, 10.0);
+  tetris_input(ctx, Pause, false);
+  tetris_advance(ctx, 0.0);
+  EXPECT_EQ(ctx->current_piece.y, start_y + 5);
+}
+
+// Test case for the clock-driven update starting, stepping and capping spans
+TEST_F(TetrisGameTest, UpdateUsesClockDifferences) {
+  const uint64_t second = 1000000000u;
+  tetris_input(ctx, Start, false);
+  tetris_update(ctx, 5 * second);  // Starts the clock and spawns
+  ASSERT_EQ(ctx->current_fsm_state, TETRIS_STATE_MOVING);
+  const int start_y = ctx->current_piece.y;
+  const uint64_t period = static_cast<uint64_t>(1e9 / tetris_gravity(ctx));
+  tetris_update(ctx, 5 * second + period + 1000);
+  EXPECT_EQ(ctx->current_piece.y, start_y + 1);
+  // A long stall counts as one second at most
+  tetris_update(ctx, 60 * second);
+  EXPECT_EQ(ctx->current_piece.y,
+            start_y + 1 + static_cast<int>(tetris_gravity(ctx) + 1e-9));
+  EXPECT_GT(tetris_clock_ns(), 0u);
+}
+
+// Test case for held shifts repeating on the engine's clock
+TEST_F(TetrisGameTest, HeldShiftRepeatsAfterDelay) {
+  tetris_set_auto_shift(ctx, 100, 20);
+  tetris_input(ctx, Start, false);
+  tetris_advance(ctx, 0.0);  // Spawn
+  ASSERT_EQ(ctx->current_fsm_state, TETRIS_STATE_MOVING);
+  const int start_x = ctx->current_piece.x;
+
+  tetris_input(ctx, Left, false);  // A press moves at once
+  EXPECT_EQ(ctx->current_piece.x, start_x - 1);
+  tetris_advance(ctx, 0.05);
+  tetris_input(ctx, Left, true);  // OS key repeats do not move
+  EXPECT_EQ(ctx->current_piece.x, start_x - 1);
+  tetris_advance(ctx, 0.05);  // Delayed auto shift
+  EXPECT_EQ(ctx->current_piece.x, start_x - 2);
+  tetris_advance(ctx, 0.02);  // Then one shift per repeat interval
+  EXPECT_EQ(ctx->current_piece.x, start_x - 3);
+
+  tetris_release(ctx, Left);
+  tetris_advance(ctx, 0.1);
+  EXPECT_EQ(ctx->current_piece.x, start_x - 3);
+
+  // A held soft drop repeats from the press, without the shift delay
+  const int start_y = ctx->current_piece.y;
+  tetris_input(ctx, Down, false);
+  tetris_advance(ctx, 0.04);
+  EXPECT_EQ(ctx->current_piece.y, start_y + 3);
+  tetris_release(ctx, Down);
+}
+
+// Test case for a key held through a restart not repeating in the new game
+TEST_F(TetrisGameTest, RestartForgetsHeldKeys) {
+  tetris_set_auto_shift(ctx, 100, 20);
+  tetris_input(ctx, Start, false);
+  tetris_advance(ctx, 0.0);  // Spawn
+  tetris_input(ctx, Left, false);  // Held, never released
+
+  tetris_input(ctx, Pause, false);
+  tetris_input(ctx, Start, false);  // Restart
+  tetris_advance(ctx, 0.0);         // Spawn
+  ASSERT_EQ(ctx->current_fsm_state, TETRIS_STATE_MOVING);
+  const int start_x = ctx->current_piece.x;
+  tetris_advance(ctx, 0.15);  // Past the shift delay
+  EXPECT_EQ(ctx->current_piece.x, start_x);
+}
+
+// Test case for a zero repeat interval shifting to the wall at once
+TEST_F(TetrisGameTest, InstantRepeatReachesWall) {
+  tetris_set_auto_shift(ctx, 50, 0);
+  tetris_input(ctx, Start, false);
+  tetris_advance(ctx, 0.0);  // Spawn
+  const CurrentPieceState& piece = ctx->current_piece;
+
+  tetris_input(ctx, Right, false);
+  tetris_input(ctx, Left, false);  // The last pressed direction wins
+  tetris_release(ctx, Right);      // Releasing the other one changes nothing
+  tetris_advance(ctx, 0.05);
+  EXPECT_FALSE(tetris_piece_fits(ctx, piece.x - 1, piece.y, piece.type, piece.rotation));
+  tetris_step(ctx);  // Single ticks never repeat
+  EXPECT_EQ(ctx->current_fsm_state, TETRIS_STATE_MOVING);
+}
+
+// Test case for contexts not sharing state
+TEST(TetrisContextTest, ContextsAreIndependent) {
+  TetrisContext running, idle;
+  tetris_init(&running, nullptr);
+  tetris_init(&idle, nullptr);
+  tetris_input(&running, Start, false);
+  tetris_step(&running);
+  tetris_step(&idle);
+  GameFrame_t frame;
+  tetris_snapshot(&running, &frame);
+  EXPECT_EQ(frame.info.current_game_state, GAME_RUNNING);
+  tetris_snapshot(&idle, &frame);
+  EXPECT_EQ(frame.info.current_game_state, START_SCREEN);
+}
+
+// Test case for a seed reproducing the same game
+TEST(TetrisContextTest, SeedIsDeterministic) {
+  TetrisContext first, second;
+  tetris_init(&first, nullptr);
+  tetris_init(&second, nullptr);
+  tetris_seed(&first, 42);
+  tetris_seed(&second, 42);
+  tetris_input(&first, Start, false);
+  tetris_input(&second, Start, false);
+  GameFrame_t a, b;
+  for (int step = 0; step < 300; ++step) {
+    UserAction_t action = step % 3 ? Left : Action;
+    tetris_input(&first, action, false);
+    tetris_input(&second, action, false);
+    tetris_step(&first);
+    tetris_step(&second);
+    tetris_snapshot(&first, &a);
+    tetris_snapshot(&second, &b);
+    for (int r = 0; r < FIELD_HEIGHT; ++r) {
+      for (int c = 0; c < FIELD_WIDTH; ++c) {
+        ASSERT_EQ(a.field_cells[r][c], b.field_cells[r][c]);
+      }
+    }
+    for (int r = 0; r < NEXT_FIELD_HEIGHT; ++r) {
+      for (int c = 0; c < NEXT_FIELD_WIDTH; ++c) {
+        ASSERT_EQ(a.next_cells[r][c], b.next_cells[r][c]);
+      }
+    }
+  }
+}
+
+// Test case for init ignoring garbage and reset releasing the autopilot
+TEST(TetrisContextTest, InitIgnoresGarbageAndResetStopsAutopilot) {
+  TetrisContext ctx;
+  std::memset(&ctx, 0xA5, sizeof(ctx));  // Whatever the stack held
+  tetris_init(&ctx, nullptr);
+  EXPECT_EQ(ctx.autopilot, nullptr);
+  tetris_input(&ctx, Start, false);
+  tetris_set_autopilot(&ctx, true);
+  ASSERT_NE(ctx.autopilot, nullptr);
+  tetris_reset(&ctx);
+  EXPECT_EQ(ctx.autopilot, nullptr);
+  EXPECT_EQ(ctx.current_fsm_state, TETRIS_STATE_START_SCREEN);
+}
+
+// Test case for many contexts stepped on separate threads
+TEST(TetrisContextTest, ContextsRunOnThreads) {
+  const int kThreads = 8;
+  const int kBoardsPerThread = 32;
+  std::vector<int> lost(kThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t, &lost] {
+      std::vector<TetrisContext> boards(kBoardsPerThread);
+      for (TetrisContext& board : boards) {
+        tetris_init(&board, nullptr);
+        tetris_input(&board, Start, false);
+      }
+      for (int step = 0; step < 2000; ++step) {
+        for (TetrisContext& board : boards) tetris_step(&board);
+      }
+      GameFrame_t frame;
+      for (const TetrisContext& board : boards) {
+        tetris_snapshot(&board, &frame);
+        lost[t] += frame.info.current_game_state == GAME_OVER_LOSE;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (int count : lost) EXPECT_EQ(count, kBoardsPerThread);
+}
+
+// Test case for the global API and its compatibility copy
+TEST(TetrisGlobalApiTest, UpdateCurrentStateCopiesFrame) {
+  initialize_tetris_game();
+  userInput(Start, false);
+  GameInfo_t info = updateCurrentState();
+  ASSERT_NE(info.field, nullptr);
+  ASSERT_NE(info.next, nullptr);
+  EXPECT_EQ(info.current_game_state, GAME_RUNNING);
+  for (int r = 0; r < FIELD_HEIGHT; ++r) free(info.field[r]);
+  free(info.field);
+  for (int r = 0; r < NEXT_FIELD_HEIGHT; ++r) free(info.next[r]);
+  free(info.next);
+  userInput(Terminate, false);
+}
+
+// Main function for running the tests
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}